@@ -0,0 +1,170 @@
+/**
+ * @file Host.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Host build run-time; io registers, real-time and watchdog clocks
+ * from the host monotonic clock, multi-tasking functions, the uart
+ * and the main function. The sketch loop() is run the number of
+ * times given as first argument (default once); sleep() returns
+ * directly so that the iterations are not paced.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Types.h"
+#include "Cosa/RTT.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/UART.hh"
+#include <time.h>
+
+// Registers referenced by the core headers
+volatile uint8_t SREG;
+volatile uint8_t PINB;
+volatile uint8_t PINC;
+volatile uint8_t PIND;
+volatile uint8_t PCMSK0;
+volatile uint8_t PCMSK1;
+volatile uint8_t PCMSK2;
+volatile uint8_t UCSR0A;
+volatile uint8_t ADCSRA;
+
+/**
+ * Return host monotonic clock in micro-seconds.
+ * @return micro-seconds.
+ */
+static uint32_t host_micros()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return ((uint32_t) now.tv_sec * 1000000UL + now.tv_nsec / 1000);
+}
+
+/**
+ * Host yield function; update the watchdog clock.
+ */
+static void host_yield()
+{
+  Watchdog::millis(RTT::millis());
+}
+
+/**
+ * Host delay function; wait given number of milli-seconds.
+ * @param[in] ms milli-seconds delay.
+ */
+static void host_delay(uint32_t ms)
+{
+  struct timespec req;
+  req.tv_sec = ms / 1000;
+  req.tv_nsec = (ms % 1000) * 1000000L;
+  nanosleep(&req, NULL);
+  host_yield();
+}
+
+/**
+ * Host sleep function; iterations of loop() are not paced.
+ * @param[in] s seconds delay (ignored).
+ */
+static void host_sleep(uint16_t s)
+{
+  UNUSED(s);
+  host_yield();
+}
+
+void (*delay)(uint32_t ms) = host_delay;
+void (*sleep)(uint16_t s) = host_sleep;
+void (*yield)() = host_yield;
+
+bool RTT::s_initiated = false;
+uint32_t RTT::s_micros = 0L;
+uint32_t RTT::s_millis = 0L;
+
+bool
+RTT::begin()
+{
+  s_initiated = true;
+  return (true);
+}
+
+bool
+RTT::end()
+{
+  s_initiated = false;
+  return (true);
+}
+
+uint16_t
+RTT::us_per_tick()
+{
+  return (1000);
+}
+
+uint16_t
+RTT::us_per_timer_cycle()
+{
+  return (1);
+}
+
+uint32_t
+RTT::micros()
+{
+  return (host_micros());
+}
+
+uint32_t
+RTT::millis()
+{
+  return (host_micros() / 1000L);
+}
+
+void
+RTT::delay(uint32_t ms)
+{
+  host_delay(ms);
+}
+
+bool Watchdog::s_initiated = false;
+uint32_t Watchdog::s_millis = 0L;
+uint16_t Watchdog::s_ms_per_tick = 16;
+
+void
+Watchdog::begin(uint16_t ms)
+{
+  s_ms_per_tick = ms;
+  s_millis = RTT::millis();
+  s_initiated = true;
+}
+
+void
+Watchdog::delay(uint32_t ms)
+{
+  host_delay(ms);
+}
+
+UART uart;
+
+extern void setup();
+extern void loop();
+
+int
+main(int argc, char* argv[])
+{
+  int count = (argc > 1) ? atoi(argv[1]) : 1;
+  setup();
+  while (count--) loop();
+  uart.end();
+  return (0);
+}
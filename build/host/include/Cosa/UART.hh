@@ -0,0 +1,108 @@
+/**
+ * @file Cosa/UART.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Host build shim; the uart is the standard output and input of the
+ * host process. Replaces the hardware UART driver so that sketches
+ * using uart and trace may be run on the host.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_UART_HH
+#define COSA_UART_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/IOStream.hh"
+#include <stdio.h>
+
+class UART : public IOStream::Device {
+public:
+  /**
+   * Start the device. The baudrate is ignored.
+   * @param[in] baudrate serial bitrate (default 9600).
+   * @return true(1).
+   */
+  bool begin(uint32_t baudrate = 9600)
+  {
+    UNUSED(baudrate);
+    return (true);
+  }
+
+  /**
+   * Stop the device; flush the output.
+   * @return true(1).
+   */
+  bool end()
+  {
+    fflush(stdout);
+    return (true);
+  }
+
+  /**
+   * @override{IOStream::Device}
+   * Write character to the standard output.
+   * @param[in] c character to write.
+   * @return character written or EOF(-1).
+   */
+  virtual int putchar(char c)
+  {
+    if (fputc(c, stdout) < 0) return (IOStream::EOF);
+    return ((uint8_t) c);
+  }
+
+  /**
+   * @override{IOStream::Device}
+   * Write data from buffer with given size to the standard output.
+   * @param[in] buf buffer to write.
+   * @param[in] size number of bytes to write.
+   * @return number of bytes written or EOF(-1).
+   */
+  virtual int write(const void* buf, size_t size)
+  {
+    return (fwrite(buf, 1, size, stdout));
+  }
+
+  /**
+   * @override{IOStream::Device}
+   * Read character from the standard input.
+   * @return character or EOF(-1).
+   */
+  virtual int getchar()
+  {
+    int c = fgetc(stdin);
+    return (c < 0 ? IOStream::EOF : c);
+  }
+
+  /**
+   * @override{IOStream::Device}
+   * Flush the standard output.
+   * @return zero(0).
+   */
+  virtual int flush()
+  {
+    fflush(stdout);
+    return (0);
+  }
+};
+
+/**
+ * Default serial port.
+ */
+extern UART uart;
+
+#endif
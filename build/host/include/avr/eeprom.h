@@ -0,0 +1,38 @@
+/**
+ * @file avr/eeprom.h
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Host build shim; EEPROM access is not supported; reads return zero
+ * and writes are ignored.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_HOST_AVR_EEPROM_H
+#define COSA_HOST_AVR_EEPROM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#define EEMEM
+inline uint8_t eeprom_read_byte(const uint8_t*){return 0;}
+inline void eeprom_write_byte(uint8_t*,uint8_t){}
+inline void eeprom_read_block(void*,const void*,size_t){}
+inline void eeprom_write_block(const void*,void*,size_t){}
+inline void eeprom_update_block(const void*,void*,size_t){}
+inline bool eeprom_is_ready(){return true;}
+
+#endif
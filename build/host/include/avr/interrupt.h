@@ -0,0 +1,37 @@
+/**
+ * @file avr/interrupt.h
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Host build shim; interrupt service routines are plain functions and
+ * there are no interrupts to enable or disable.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_HOST_AVR_INTERRUPT_H
+#define COSA_HOST_AVR_INTERRUPT_H
+
+#define ISR(v, ...) extern "C" void v(void); void v(void)
+#define EMPTY_INTERRUPT(v) extern "C" void v(void) {}
+#define ISR_NAKED
+#define ISR_NOBLOCK
+#define ISR_ALIASOF(v)
+#define sei()
+#define cli()
+#define reti()
+
+#endif
@@ -0,0 +1,54 @@
+/**
+ * @file avr/io.h
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Host build shim; ATmega328P io registers as plain variables.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_HOST_AVR_IO_H
+#define COSA_HOST_AVR_IO_H
+
+#include <stdint.h>
+
+#define __AVR_ATmega328P__ 1
+
+#define _BV(bit) (1 << (bit))
+
+/** Registers referenced by the core headers. */
+extern volatile uint8_t SREG;
+extern volatile uint8_t PINB;
+extern volatile uint8_t PINC;
+extern volatile uint8_t PIND;
+extern volatile uint8_t PCMSK0;
+extern volatile uint8_t PCMSK1;
+extern volatile uint8_t PCMSK2;
+extern volatile uint8_t UCSR0A;
+extern volatile uint8_t ADCSRA;
+
+/** Analog converter enable bit. */
+#define ADEN 7
+
+/** Analog multiplexer selection bits. */
+#define MUX1 1
+#define MUX2 2
+#define MUX3 3
+#define REFS0 6
+#define REFS1 7
+
+#endif
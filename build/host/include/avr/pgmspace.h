@@ -0,0 +1,58 @@
+/**
+ * @file avr/pgmspace.h
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Host build shim; program memory is data memory. Program memory words
+ * in tables of pointers are read as host pointers.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_HOST_AVR_PGMSPACE_H
+#define COSA_HOST_AVR_PGMSPACE_H
+
+#include <stdint.h>
+#include <string.h>
+#define PROGMEM
+#define PSTR(s) (s)
+#define PGM_P const char*
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define pgm_read_word(p) (sizeof(*(p)) == 2 ? (uintptr_t) *(const uint16_t*)(p) : *(const uintptr_t*)(p))
+#define pgm_read_dword(p) (*(const uint32_t*)(p))
+#define pgm_read_float(p) (*(const float*)(p))
+#define pgm_read_ptr(p) (*(void* const*)(p))
+#include <stdio.h>
+#undef EOF
+#include <strings.h>
+inline void* memcpy_P(void* d, const void* s, size_t n) { return memcpy(d,s,n); }
+inline int memcmp_P(const void* a, const void* b, size_t n) { return memcmp(a,b,n); }
+inline size_t strlen_P(const char* s) { return strlen(s); }
+inline int strcmp_P(const char* a, const char* b) { return strcmp(a,b); }
+inline int strncmp_P(const char* a, const char* b, size_t n) { return strncmp(a,b,n); }
+inline int strcasecmp_P(const char* a, const char* b) { return strcasecmp(a,b); }
+inline char* strcpy_P(char* a, const char* b) { return strcpy(a,b); }
+inline char* strncpy_P(char* a, const char* b, size_t n) { return strncpy(a,b,n); }
+inline char* strcat_P(char* a, const char* b) { return strcat(a,b); }
+inline const char* strchr_P(const char* a, int c) { return strchr(a,c); }
+inline const char* strchrnul_P(const char* a, int c) { return strchr(a,c); }
+inline char* strcasestr_P(const char* a, const char* b) { return (char*) strstr(a,b); }
+inline char* strstr_P(const char* a, const char* b) { return (char*) strstr(a,b); }
+#define sprintf_P sprintf
+#define vsnprintf_P vsnprintf
+#define snprintf_P snprintf
+
+#endif
@@ -0,0 +1,46 @@
+/**
+ * @file avr/power.h
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Host build shim; module power control is ignored.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_HOST_AVR_POWER_H
+#define COSA_HOST_AVR_POWER_H
+
+#define power_adc_enable()
+#define power_adc_disable()
+#define power_usart0_enable()
+#define power_usart0_disable()
+#define power_spi_enable()
+#define power_spi_disable()
+#define power_timer0_enable()
+#define power_timer0_disable()
+#define power_timer1_enable()
+#define power_timer1_disable()
+#define power_timer2_enable()
+#define power_timer2_disable()
+#define power_twi_enable()
+#define power_twi_disable()
+#define power_usi_enable()
+#define power_usi_disable()
+#define power_all_enable()
+#define power_all_disable()
+
+#endif
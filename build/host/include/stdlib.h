@@ -0,0 +1,75 @@
+/**
+ * @file stdlib.h
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Host build shim; the host standard library with the AVR libc
+ * number to string conversion extensions.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_HOST_STDLIB_H
+#define COSA_HOST_STDLIB_H
+
+#include_next <stdlib.h>
+#include <stdio.h>
+
+inline char* ultoa(unsigned long value, char* s, int base)
+{
+  char* p = s;
+  do {
+    unsigned int digit = value % base;
+    *p++ = (digit < 10) ? '0' + digit : 'a' + digit - 10;
+    value /= base;
+  } while (value != 0);
+  *p = 0;
+  for (char* q = s; q < --p; q++) {
+    char c = *q;
+    *q = *p;
+    *p = c;
+  }
+  return (s);
+}
+
+inline char* ltoa(long value, char* s, int base)
+{
+  if ((value < 0) && (base == 10)) {
+    *s = '-';
+    ultoa(-value, s + 1, base);
+    return (s);
+  }
+  return (ultoa(value, s, base));
+}
+
+inline char* utoa(unsigned int value, char* s, int base)
+{
+  return (ultoa(value, s, base));
+}
+
+inline char* itoa(int value, char* s, int base)
+{
+  return (ltoa(value, s, base));
+}
+
+inline char* dtostrf(double value, signed char width, unsigned char prec,
+		     char* s)
+{
+  sprintf(s, "%*.*f", width, prec, value);
+  return (s);
+}
+
+#endif
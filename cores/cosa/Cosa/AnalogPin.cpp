@@ -20,6 +20,78 @@
 
 #include "Cosa/AnalogPin.hh"
 
+AnalogPin::Filter::Filter(uint8_t bits, uint8_t order, uint8_t smooth) :
+  m_bits(bits),
+  m_order(order == 0 ? 1 : (order > ORDER_MAX ? ORDER_MAX : order)),
+  m_smooth(smooth > SMOOTH_MAX ? SMOOTH_MAX : smooth)
+{
+  // Limit extra bits to output and integrator width
+  if (m_bits > BITS_MAX) m_bits = BITS_MAX;
+  if (m_bits > ORDER_BITS_MAX / m_order) m_bits = ORDER_BITS_MAX / m_order;
+  reset();
+}
+
+void
+AnalogPin::Filter::reset()
+{
+  synchronized {
+    m_primed = false;
+    m_count = 0;
+    m_value = 0;
+    m_average = 0;
+    memset(m_integrator, 0, sizeof(m_integrator));
+    memset(m_comb, 0, sizeof(m_comb));
+  }
+}
+
+bool
+AnalogPin::Filter::update(uint16_t sample)
+{
+  // Integrator stages at conversion rate; modulo arithmetic
+  uint32_t x = sample;
+  for (uint8_t i = 0; i < m_order; i++) {
+    m_integrator[i] += x;
+    x = m_integrator[i];
+  }
+  if (++m_count < decimation()) return (false);
+  m_count = 0;
+
+  // Comb stages at output rate
+  for (uint8_t i = 0; i < m_order; i++) {
+    uint32_t y = x - m_comb[i];
+    m_comb[i] = x;
+    x = y;
+  }
+
+  // Scale the gain, 4^(bits * order), and keep the extra bits
+  x >>= m_bits * ((m_order << 1) - 1);
+
+  // Exponential moving average; initiate with first output
+  if (m_smooth != 0) {
+    if (!m_primed) {
+      m_average = x << m_smooth;
+      m_primed = true;
+    }
+    else {
+      m_average += x - (m_average >> m_smooth);
+    }
+    x = m_average >> m_smooth;
+  }
+  m_value = x;
+  return (true);
+}
+
+uint16_t
+AnalogPin::sample_filter()
+{
+  uint16_t sample;
+  do {
+    sample = AnalogPin::sample(m_pin, m_reference);
+    if (UNLIKELY(sample == UINT16_MAX)) return (sample);
+  } while (!m_filter->update(sample));
+  return (m_value = m_filter->value());
+}
+
 bool
 AnalogPin::sample_request(Board::AnalogPin pin, uint8_t ref)
 {
@@ -38,6 +110,10 @@ uint16_t
 AnalogPin::sample_await()
 {
   if (UNLIKELY(sampling_pin != this)) return (m_value);
+  if (m_filter != NULL) {
+    while (sampling_pin == this) yield();
+    return (m_value);
+  }
   synchronized {
     sampling_pin = NULL;
     bit_clear(ADCSRA, ADIE);
@@ -64,6 +140,14 @@ AnalogPin::on_event(uint8_t type, uint16_t value)
 void
 AnalogPin::on_interrupt(uint16_t value)
 {
+  // Restart conversion until the filter has a new output value
+  if (m_filter != NULL) {
+    if (!m_filter->update(value)) {
+      bit_mask_set(ADCSRA, _BV(ADSC) | _BV(ADIE));
+      return;
+    }
+    value = m_filter->value();
+  }
   uint8_t event = sampling_pin->m_event;
   if (event == Event::NULL_TYPE)
     sampling_pin->m_value = value;
@@ -31,6 +31,105 @@
  */
 class AnalogPin : public Interrupt::Handler, public Event::Handler {
 public:
+  /**
+   * Oversampling and decimation filter. Conversions are passed
+   * through a Cascaded Integrator-Comb (CIC) decimator with the
+   * decimation rate 4^n, where n is the number of extra bits of
+   * resolution. The order one filter is the plain accumulate and
+   * dump oversampling. Higher order gives better alias rejection.
+   * The output may be smoothed with an exponential moving average.
+   * The filter is updated in the interrupt service routine and does
+   * not require any sample buffer.
+   *
+   * @section Limitations
+   * The first (order - 1) outputs after reset are transient. The
+   * 16-bit output limits the extra bits to BITS_MAX (6), and the
+   * 32-bit integrators, that must hold 10 + 2 * order * bits bits,
+   * limit order * bits to 11; max 6, 5 and 3 extra bits for order
+   * 1, 2 and 3. The smoothing factor is limited to SMOOTH_MAX. Larger
+   * values are reduced to the limits by the constructor.
+   */
+  class Filter {
+  public:
+    /** Max filter order. */
+    static const uint8_t ORDER_MAX = 3;
+
+    /** Max extra bits of resolution (16-bit output). */
+    static const uint8_t BITS_MAX = 6;
+
+    /** Max order * bits (32-bit integrators). */
+    static const uint8_t ORDER_BITS_MAX = 11;
+
+    /** Max smoothing factor (32-bit moving average). */
+    static const uint8_t SMOOTH_MAX = 16;
+
+    /**
+     * Construct filter with given number of extra bits of resolution
+     * (decimation rate 4^bits), order and smoothing factor. The
+     * parameters are reduced to the filter limits.
+     * @param[in] bits extra bits of resolution, 0..BITS_MAX and
+     *   order * bits <= ORDER_BITS_MAX (default 0).
+     * @param[in] order CIC filter order, 1..ORDER_MAX (default 1).
+     * @param[in] smooth moving average weight 1/2^smooth,
+     *   0..SMOOTH_MAX (default 0).
+     */
+    Filter(uint8_t bits = 0, uint8_t order = 1, uint8_t smooth = 0);
+
+    /**
+     * Reset filter state.
+     */
+    void reset();
+
+    /**
+     * Update filter with given conversion value. Return true(1) if a
+     * new output value is available otherwise false(0).
+     * @param[in] sample conversion value.
+     * @return bool.
+     */
+    bool update(uint16_t sample);
+
+    /**
+     * Get latest output value.
+     * @return filter output.
+     * @note atomic
+     */
+    uint16_t value() const
+    {
+      uint16_t res;
+      synchronized res = m_value;
+      return (res);
+    }
+
+    /**
+     * Get output resolution in bits.
+     * @return number of bits.
+     */
+    uint8_t resolution() const
+    {
+      return (10 + m_bits);
+    }
+
+    /**
+     * Get decimation rate; number of conversions per output.
+     * @return decimation rate.
+     */
+    uint16_t decimation() const
+    {
+      return (((uint16_t) 1) << (m_bits << 1));
+    }
+
+  protected:
+    uint8_t m_bits;		   //!< Extra bits of resolution.
+    uint8_t m_order;		   //!< CIC filter order.
+    uint8_t m_smooth;		   //!< Moving average weight (log2).
+    bool m_primed;		   //!< Moving average initiated.
+    uint16_t m_count;		   //!< Conversions since latest output.
+    uint16_t m_value;		   //!< Latest output value.
+    uint32_t m_average;		   //!< Moving average (scaled).
+    uint32_t m_integrator[ORDER_MAX]; //!< Integrator stages.
+    uint32_t m_comb[ORDER_MAX];	   //!< Comb stages (delay).
+  };
+
   /**
    * Construct abstract analog pin for given pin (channel) and
    * reference voltage.
@@ -41,9 +140,31 @@ public:
     m_pin(pin),
     m_reference(ref),
     m_value(0),
-    m_event(Event::NULL_TYPE)
+    m_event(Event::NULL_TYPE),
+    m_filter(NULL)
   {}
 
+  /**
+   * Set oversampling and decimation filter for the pin. Sampling
+   * completes when the filter has a new output value. Pass NULL to
+   * remove the filter.
+   * @param[in] filter oversampling filter.
+   */
+  void filter(Filter* filter)
+  {
+    if (filter != NULL) filter->reset();
+    m_filter = filter;
+  }
+
+  /**
+   * Get oversampling and decimation filter for the pin.
+   * @return filter or NULL.
+   */
+  Filter* filter() const
+  {
+    return (m_filter);
+  }
+
   /**
    * Set reference voltage for conversion.
    * @param[in] ref reference voltage.
@@ -129,12 +250,14 @@ public:
 
   /**
    * Sample analog pin. Wait for conversion to complete before
-   * returning with sample value.
+   * returning with sample value. With a filter the conversions are
+   * repeated until the filter has a new output value.
    * @return sample value.
    */
   uint16_t sample()
     __attribute__((always_inline))
   {
+    if (m_filter != NULL) return (sample_filter());
     return (m_value = AnalogPin::sample(m_pin, m_reference));
   }
 
@@ -203,6 +326,14 @@ protected:
   Board::Reference m_reference;	  //!< ADC reference voltage type.
   uint16_t m_value;		  //!< Latest sample value.
   uint8_t m_event;		  //!< Event to push on completion.
+  Filter* m_filter;		  //!< Oversampling filter if any.
+
+  /**
+   * Internal sample analog pin with filter. Repeat conversions until
+   * the filter has a new output value.
+   * @return filter output value.
+   */
+  uint16_t sample_filter();
 
   /**
    * Internal request sample of analog pin. Set up sampling of given pin
@@ -19,6 +19,7 @@
  */
 
 #include "Cosa/AnalogPins.hh"
+#include "Cosa/Power.hh"
 
 bool
 AnalogPins::samples_request()
@@ -27,9 +28,165 @@ AnalogPins::samples_request()
   return (AnalogPin::sample_request(pin_at(m_next), m_reference));
 }
 
+#if !defined(BOARD_ATTINY)
+/** Min number of ADC clock cycles per conversion (incl. interrupt). */
+static const uint8_t ADC_CYCLES_MIN = 16;
+
+bool
+AnalogPins::stream_begin(uint16_t* buf, uint8_t scans, uint16_t hz)
+{
+  if (UNLIKELY(buf == NULL || scans == 0 || hz == 0)) return (false);
+
+  // Conversion trigger period; one pin per trigger
+  uint32_t cycles = F_CPU / ((uint32_t) hz * m_count);
+
+  // Check that the ADC clock prescale allows the rate
+  uint8_t adps = (ADCSRA & (_BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0)));
+  uint8_t factor = (adps == 0 ? 2 : _BV(adps));
+  if (UNLIKELY(cycles < (uint32_t) ADC_CYCLES_MIN * factor)) return (false);
+
+  // Select the smallest timer prescale that gives a 16-bit period
+  uint8_t cs;
+  uint8_t shift;
+  if (cycles <= 0x10000UL) {
+    cs = _BV(CS10);
+    shift = 0;
+  }
+  else if (cycles <= 0x80000UL) {
+    cs = _BV(CS11);
+    shift = 3;
+  }
+  else if (cycles <= 0x400000UL) {
+    cs = _BV(CS11) | _BV(CS10);
+    shift = 6;
+  }
+  else if (cycles <= 0x1000000UL) {
+    cs = _BV(CS12);
+    shift = 8;
+  }
+  else if (cycles <= 0x4000000UL) {
+    cs = _BV(CS12) | _BV(CS10);
+    shift = 10;
+  }
+  else return (false);
+  uint16_t top = ((cycles + ((1UL << shift) >> 1)) >> shift) - 1;
+
+  // Check that the ADC is not in use
+  loop_until_bit_is_clear(ADCSRA, ADSC);
+  synchronized {
+    if (UNLIKELY(sampling_pin != NULL)) return (false);
+    sampling_pin = this;
+  }
+
+  // Initiate buffer and state
+  m_stream = buf;
+  m_size = scans * m_count;
+  m_put = 0;
+  m_pending = 0;
+  m_skip = false;
+  m_overruns = 0;
+  m_period = ((uint32_t) top + 1) << shift;
+  m_partial = false;
+  m_next = 0;
+  if (m_filters != NULL) {
+    for (uint8_t i = 0; i < m_count; i++)
+      if (m_filters[i] != NULL) m_filters[i]->reset();
+  }
+
+  // Timer1 in CTC mode; compare match B triggers the conversion
+  Power::timer1_enable();
+  TCCR1B = 0;
+  TCCR1A = 0;
+  TCNT1 = 0;
+  OCR1A = top;
+  OCR1B = top;
+  TIFR1 = _BV(OCF1B);
+
+  // ADC auto-trigger on Timer1 compare match B with the first pin
+  channel(pin_at(0));
+  bit_field_set(ADCSRB, _BV(ADTS2) | _BV(ADTS1) | _BV(ADTS0),
+		_BV(ADTS2) | _BV(ADTS0));
+  bit_set(ADCSRA, ADIF);
+  bit_mask_set(ADCSRA, _BV(ADEN) | _BV(ADATE) | _BV(ADIE));
+
+  // And start the timer
+  TCCR1B = _BV(WGM12) | cs;
+  return (true);
+}
+
+void
+AnalogPins::stream_end()
+{
+  if (UNLIKELY(m_stream == NULL)) return;
+  synchronized {
+    TCCR1B = 0;
+    bit_mask_clear(ADCSRA, _BV(ADATE) | _BV(ADIE));
+    bit_field_set(ADCSRB, _BV(ADTS2) | _BV(ADTS1) | _BV(ADTS0), 0);
+    m_stream = NULL;
+    sampling_pin = NULL;
+  }
+  Power::timer1_disable();
+}
+
+void
+AnalogPins::stream_release(const uint16_t* buf)
+{
+  uint8_t half = (buf == m_stream ? _BV(0) : _BV(1));
+  synchronized m_pending &= ~half;
+}
+#endif
+
 void
 AnalogPins::on_interrupt(uint16_t value)
 {
+#if !defined(BOARD_ATTINY)
+  // Continuous sampling; select next pin and rearm trigger and interrupt
+  if (m_stream != NULL) {
+    uint8_t next = m_next + 1;
+    if (next == m_count) next = 0;
+    channel(pin_at(next));
+    TIFR1 = _BV(OCF1B);
+    bit_set(ADCSRA, ADIE);
+    if (m_filters != NULL) {
+      Filter* filter = m_filters[m_next];
+      if (filter != NULL) {
+	if (!filter->update(value)) m_partial = true;
+	value = filter->value();
+      }
+    }
+    if (!m_skip) m_stream[m_put++] = value;
+    m_next = next;
+    if (next != 0) return;
+
+    // Scan completed; discard if filter output is missing
+    if (m_partial) {
+      m_partial = false;
+      if (!m_skip) m_put -= m_count;
+      return;
+    }
+
+    // Push event when a half is full
+    if (m_skip) {
+      m_overruns += 1;
+    }
+    else if (m_put == m_size || m_put == (m_size << 1)) {
+      uint8_t half = (m_put == m_size ? _BV(0) : _BV(1));
+      uint16_t* buf = m_stream + m_put - m_size;
+      if (Event::push(Event::RECEIVE_COMPLETED_TYPE, this, buf))
+	m_pending |= half;
+      else
+	m_overruns += 1;
+      if (m_put != m_size) m_put = 0;
+    }
+
+    // Drop scans while the next half is in use
+    if (m_put == 0)
+      m_skip = ((m_pending & _BV(0)) != 0);
+    else if (m_put == m_size)
+      m_skip = ((m_pending & _BV(1)) != 0);
+    return;
+  }
+#endif
   sampling_pin = 0;
   m_buffer[m_next++] = value;
   if (m_next != m_count) {
@@ -26,6 +26,20 @@
 /**
  * Abstract analog pin set. Allow sampling of a set of pins with
  * interrupt or event handler when completed.
+ *
+ * The pin set may also be sampled continuously (streaming). The
+ * conversions are started by Timer1 (ADC auto-trigger on compare
+ * match B) with one pin converted per trigger. Scans are stored in a
+ * ping-pong buffer and an event is pushed when each half is full.
+ * The application releases the buffer when processed. Scans are
+ * dropped and counted as overruns while the next buffer is in use.
+ * The pins may have oversampling and decimation filters; a scan is
+ * stored when all filters have a new output value.
+ *
+ * @section Limitations
+ * Streaming uses Timer1. Cannot be used with libraries that use the
+ * same Timer; Tone, VWI, Servo, InputCapture. Not available on
+ * ATtiny.
  */
 class AnalogPins : private AnalogPin {
 public:
@@ -46,6 +60,18 @@ public:
     m_buffer(buffer),
     m_count(count),
     m_next(0)
+#if !defined(BOARD_ATTINY)
+    ,
+    m_stream(NULL),
+    m_size(0),
+    m_put(0),
+    m_pending(0),
+    m_skip(false),
+    m_overruns(0),
+    m_period(0),
+    m_filters(NULL),
+    m_partial(false)
+#endif
   {
   }
 
@@ -75,6 +101,92 @@ public:
    */
   bool samples_request();
 
+#if !defined(BOARD_ATTINY)
+  /**
+   * Start continuous sampling of the analog pin set with the given
+   * scan rate (samples per second per pin). The given buffer must
+   * hold two halves of the given number of scans; 2 * scans * count()
+   * samples. A RECEIVE_COMPLETED_TYPE event is pushed with a pointer
+   * to the half when it is full (see Event::env()); the half should be
+   * passed to stream_release() when processed. Returns true(1) if
+   * successful otherwise false(0); the ADC is busy, illegal parameters,
+   * the rate cannot be generated by the timer or is too high for the
+   * ADC clock prescale.
+   * @param[in] buf ping-pong sample buffer.
+   * @param[in] scans number of scans per half.
+   * @param[in] hz scan rate.
+   * @return bool.
+   */
+  bool stream_begin(uint16_t* buf, uint8_t scans, uint16_t hz);
+
+  /**
+   * Stop continuous sampling.
+   */
+  void stream_end();
+
+  /**
+   * Set oversampling and decimation filters for continuous sampling.
+   * The given vector should contain count() filters (or NULL for no
+   * filter). The decimation rates must be powers of four so that the
+   * filter outputs are aligned; a scan is stored when all filters have
+   * a new output value, i.e. at the rate of the largest decimation.
+   * Should be set before stream_begin(). Pass NULL to remove.
+   * @param[in] filters vector with filters.
+   */
+  void filters(Filter** filters)
+  {
+    m_filters = filters;
+  }
+
+  /**
+   * Release given buffer half so that it may be filled again.
+   * @param[in] buf buffer half.
+   */
+  void stream_release(const uint16_t* buf);
+
+  /**
+   * Get scan period in processor clock cycles. The exact scan rate
+   * is F_CPU / stream_period().
+   * @return clock cycles.
+   */
+  uint32_t stream_period() const
+  {
+    return (m_period * m_count);
+  }
+
+  /**
+   * Get scan rate (rounded to nearest Hz).
+   * @return scan rate.
+   */
+  uint16_t stream_rate() const
+  {
+    uint32_t period = stream_period();
+    if (UNLIKELY(period == 0)) return (0);
+    return ((F_CPU + (period / 2)) / period);
+  }
+
+  /**
+   * Get number of dropped scans since stream_begin().
+   * @return number of overruns.
+   * @note atomic
+   */
+  uint16_t overruns() const
+  {
+    uint16_t res;
+    synchronized res = m_overruns;
+    return (res);
+  }
+
+  /**
+   * Return true(1) if streaming otherwise false(0).
+   * @return bool.
+   */
+  bool is_streaming() const
+  {
+    return (m_stream != NULL);
+  }
+#endif
+
   /**
    * @override{Interrupt::Handler}
    * Interrupt service on conversion completion.
@@ -99,6 +211,30 @@ private:
   uint16_t* m_buffer;		    //!< Sample vector.
   uint8_t m_count;		    //!< Number of samples.
   uint8_t m_next;		    //!< Next analog channel (index).
+#if !defined(BOARD_ATTINY)
+  uint16_t* m_stream;		    //!< Streaming ping-pong buffer.
+  uint16_t m_size;		    //!< Number of samples per half.
+  uint16_t m_put;		    //!< Next sample (index).
+  uint8_t m_pending;		    //!< Halves in use by application.
+  bool m_skip;			    //!< Dropping scans.
+  uint16_t m_overruns;		    //!< Number of dropped scans.
+  uint32_t m_period;		    //!< Trigger period (clock cycles).
+  Filter** m_filters;		    //!< Oversampling filters if any.
+  bool m_partial;		    //!< Filter output missing in scan.
+
+  /**
+   * Select given pin as next channel for conversion.
+   * @param[in] pin analog pin.
+   */
+  void channel(Board::AnalogPin pin)
+    __attribute__((always_inline))
+  {
+    ADMUX = (m_reference | (pin & 0x1f));
+#if defined(MUX5)
+    bit_write(pin & 0x20, ADCSRB, MUX5);
+#endif
+  }
+#endif
 };
 
 #endif
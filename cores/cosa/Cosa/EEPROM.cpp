@@ -23,12 +23,15 @@
 bool
 EEPROM::Device::is_ready()
 {
-  return (eeprom_is_ready());
+  return (s_queue.is_empty() && eeprom_is_ready());
 }
 
 int
 EEPROM::Device::read(void* dest, const void* src, size_t size)
 {
+  // Wait for posted updates to complete
+  while (!s_queue.is_empty()) yield();
+
   uint8_t* dp = (uint8_t*) dest;
   const uint8_t* sp = (const uint8_t*) src;
   size_t res = size;
@@ -39,11 +42,91 @@ EEPROM::Device::read(void* dest, const void* src, size_t size)
 int
 EEPROM::Device::write(void* dest, const void* src, size_t size)
 {
+  // Wait for posted updates to complete
+  while (!s_queue.is_empty()) yield();
+
+  // Write the bytes that differ
   uint8_t* dp = (uint8_t*) dest;
   const uint8_t* sp = (const uint8_t*) src;
   size_t res = size;
-  while (size--) eeprom_write_byte(dp++, *sp++);
+  while (size--) eeprom_update_byte(dp++, *sp++);
   return (res);
 }
 
+bool
+EEPROM::Device::post(Update* update)
+{
+  // Sanity check the update
+  if (UNLIKELY(update->is_pending() || (update->m_src == NULL))) return (false);
+  update->m_ix = 0;
+
+#if defined(EE_READY_vect)
+  // Append internal EEPROM update to queue and enable the interrupt
+  if (this == &eeprom) {
+    synchronized {
+      update->enqueue(&s_queue);
+      EECR |= _BV(EERIE);
+    }
+    return (true);
+  }
+#endif
+
+  // Other devices; write the block and notify directly
+  int res = write(update->m_dest, update->m_src, update->m_size);
+  if (UNLIKELY(res < 0)) return (false);
+  update->m_count = res;
+  update->complete(Event::WRITE_COMPLETED_TYPE);
+  return (true);
+}
+
+Head EEPROM::Device::s_queue;
+
 EEPROM::Device EEPROM::Device::eeprom;
+
+void
+EEPROM::Device::on_ready_interrupt()
+{
+  while (!s_queue.is_empty()) {
+    Update* update = (Update*) s_queue.succ();
+
+    // Start programming of the next changed byte
+    while (update->m_ix < update->m_size) {
+      uint8_t* dp = update->m_dest + update->m_ix;
+      uint8_t data = update->m_src[update->m_ix];
+      update->m_ix += 1;
+      EEAR = (uint16_t) dp;
+      EECR |= _BV(EERE);
+      uint8_t old = EEDR;
+      if (old == data) continue;
+
+      // Erase only (3.4 ms => 1.8 ms) when all bits are set, write
+      // only (1.8 ms) when bits are only cleared otherwise both
+      uint8_t mode;
+      if (data == 0xff)
+	mode = _BV(EEPM0);
+      else if ((old & data) == data)
+	mode = _BV(EEPM1);
+      else
+	mode = 0;
+      EECR = mode | _BV(EERIE);
+      EEDR = data;
+      EECR |= _BV(EEMPE);
+      EECR |= _BV(EEPE);
+      update->m_count += 1;
+      return;
+    }
+
+    // Update completed; notify and continue with the next update
+    update->complete(Event::WRITE_COMPLETED_TYPE);
+  }
+
+  // Queue is empty; disable the interrupt
+  EECR &= ~_BV(EERIE);
+}
+
+#if defined(EE_READY_vect)
+ISR(EE_READY_vect)
+{
+  EEPROM::Device::on_ready_interrupt();
+}
+#endif
@@ -23,6 +23,13 @@
 
 #include "Cosa/Types.h"
 #include "Cosa/Power.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/Request.hh"
+
+// Some processors use an alternative name for the EEPROM ready vector
+#if !defined(EE_READY_vect) && defined(EE_RDY_vect)
+#define EE_READY_vect EE_RDY_vect
+#endif
 
 /**
  * Driver for the ATmega/ATtiny internal EEPROM and abstraction of
@@ -39,6 +46,54 @@ public:
    */
   class Device {
   public:
+    /**
+     * Asynchronous update of a rom block; the bytes that differ from
+     * the buffer are written. Updates are posted to the device and
+     * performed by the EEPROM ready interrupt handler for the internal
+     * EEPROM. Each byte is erased only, written only or erased and
+     * written depending on the old and new bit pattern, and unchanged
+     * bytes are skipped. The buffer must be valid until completed.
+     * Completion is signaled with an Event::WRITE_COMPLETED_TYPE and
+     * the count is the number of bytes programmed; changed bytes.
+     */
+    class Update : public Request {
+    public:
+      /**
+       * Construct update with given completion event target.
+       * @param[in] target completion event handler (Default NULL).
+       */
+      Update(Event::Handler* target = NULL) :
+	Request(target),
+	m_dest(NULL),
+	m_src(NULL),
+	m_size(0),
+	m_ix(0)
+      {}
+
+      /**
+       * Set rom block address, buffer and size for the update. Must
+       * not be called while pending.
+       * @param[in] dest address in rom to write to.
+       * @param[in] src buffer to write to rom.
+       * @param[in] size number of bytes to write.
+       */
+      void set(void* dest, const void* src, size_t size)
+      {
+	m_dest = (uint8_t*) dest;
+	m_src = (const uint8_t*) src;
+	m_size = size;
+      }
+
+    protected:
+      uint8_t* m_dest;			//!< Address in rom.
+      const uint8_t* m_src;		//!< Buffer to write.
+      size_t m_size;			//!< Number of bytes.
+      size_t m_ix;			//!< Index of next byte.
+
+      /** Allow access. */
+      friend class Device;
+    };
+
     /**
      * @override{EEPROM::Device}
      * Return true(1) if the device is ready, write cycle is completed,
@@ -69,10 +124,45 @@ public:
      */
     virtual int write(void* dest, const void* src, size_t size);
 
+    /**
+     * Post given update. Returns immediately for the internal EEPROM;
+     * the update is performed by the interrupt handler. Other devices
+     * write the block and push the completion event directly. Return
+     * true(1) if successful otherwise false(0); the update is already
+     * pending or has no buffer.
+     * @param[in] update rom block update.
+     * @return bool.
+     */
+    bool post(Update* update);
+
+    /**
+     * Return true(1) if there are pending updates otherwise false(0).
+     * @return bool.
+     */
+    static bool is_queued()
+    {
+      return (!s_queue.is_empty());
+    }
+
     /**
      * Default EEPROM device; handling of internal EEPROM Data Memory.
      */
     static Device eeprom;
+
+  protected:
+    /** Queue of internal EEPROM updates. */
+    static Head s_queue;
+
+    /**
+     * EEPROM ready interrupt handler; start programming of the next
+     * changed byte in the queued updates.
+     */
+    static void on_ready_interrupt();
+
+#if defined(EE_READY_vect)
+    /** Allow access. */
+    friend void EE_READY_vect(void);
+#endif
   };
 
 public:
@@ -265,6 +355,19 @@ public:
     return (m_dev->write(dest, &src, sizeof(float)));
   }
 
+  /**
+   * Post given rom block update to the device. Returns immediately
+   * for the internal EEPROM. Return true(1) if successful otherwise
+   * false(0).
+   * @param[in] update rom block update.
+   * @return bool.
+   */
+  bool post(Device::Update* update)
+    __attribute__((always_inline))
+  {
+    return (m_dev->post(update));
+  }
+
 private:
   Device* m_dev;		//!< Delegated device.
 };
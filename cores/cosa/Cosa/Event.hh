@@ -157,7 +157,7 @@ public:
    */
   void* env() const
   {
-    return ((void*) m_value);
+    return ((void*) (uintptr_t) m_value);
   }
 
   /**
@@ -195,7 +195,7 @@ public:
   static bool push(uint8_t type, Handler* target, void* env)
     __attribute__((always_inline))
   {
-    return (push(type, target, (uint16_t) env));
+    return (push(type, target, (uint16_t) (uintptr_t) env));
   }
 
   /**
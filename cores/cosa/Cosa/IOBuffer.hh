@@ -143,6 +143,7 @@ public:
   }
 
 private:
+  friend class IORing;
   static const uint16_t MASK = (SIZE - 1);
   volatile uint16_t m_head;
   volatile uint16_t m_tail;
@@ -201,4 +202,127 @@ IOBuffer<SIZE>::flush()
   return (0);
 }
 
+/**
+ * Direct access to the circular buffer of an IOBuffer instance
+ * without the virtual IOStream::Device member functions. Allows
+ * device drivers to hold an IOBuffer of any size and perform inline
+ * ring operations in interrupt handlers. See UART.
+ */
+class IORing {
+public:
+  /**
+   * Construct detached ring access.
+   */
+  IORing() :
+    m_head(NULL),
+    m_tail(NULL),
+    m_buffer(NULL),
+    m_mask(0)
+  {}
+
+  /**
+   * Attach to the circular buffer of the given IOBuffer.
+   * @param[in] buf io buffer.
+   */
+  template <uint16_t SIZE>
+  void attach(IOBuffer<SIZE>* buf)
+  {
+    m_head = &buf->m_head;
+    m_tail = &buf->m_tail;
+    m_buffer = buf->m_buffer;
+    m_mask = IOBuffer<SIZE>::MASK;
+  }
+
+  /**
+   * Return true(1) if attached to an io buffer otherwise false(0).
+   * @return bool.
+   */
+  bool is_attached() const
+    __attribute__((always_inline))
+  {
+    return (m_buffer != NULL);
+  }
+
+  /**
+   * Return buffer head (put) index. Used by the producer to mark a
+   * position that it may return to with rewind().
+   * @return head index.
+   */
+  uint16_t mark() const
+    __attribute__((always_inline))
+  {
+    return (*m_head);
+  }
+
+  /**
+   * Remove characters written after the given head (put) index. May
+   * only be used by the producer and when the consumer has not read
+   * beyond the mark.
+   * @param[in] head index from mark().
+   */
+  void rewind(uint16_t head)
+    __attribute__((always_inline))
+  {
+    *m_head = head;
+  }
+
+  /**
+   * Write character to buffer.
+   * @param[in] c character to write.
+   * @return character written or EOF(-1).
+   */
+  int putchar(char c)
+    __attribute__((always_inline))
+  {
+    uint16_t next = (*m_head + 1) & m_mask;
+    if (UNLIKELY(next == *m_tail)) return (IOStream::EOF);
+    m_buffer[next] = c;
+    *m_head = next;
+    return (c & 0xff);
+  }
+
+  /**
+   * Read character from buffer.
+   * @return character or EOF(-1).
+   */
+  int getchar()
+    __attribute__((always_inline))
+  {
+    uint16_t tail = *m_tail;
+    if (UNLIKELY(*m_head == tail)) return (IOStream::EOF);
+    tail = (tail + 1) & m_mask;
+    *m_tail = tail;
+    return (m_buffer[tail] & 0xff);
+  }
+
+  /**
+   * Write as many characters from the given buffer as there is room
+   * for. The buffer head is updated once so that an interrupt handler
+   * consuming the buffer sees the whole chunk. Returns number of
+   * characters written.
+   * @param[in] buf buffer to write.
+   * @param[in] size number of bytes in buffer.
+   * @return number of characters written.
+   */
+  size_t write(const void* buf, size_t size)
+  {
+    uint16_t head = *m_head;
+    uint16_t room = (m_mask - head + *m_tail) & m_mask;
+    if (size > room) size = room;
+    const char* bp = (const char*) buf;
+    for (size_t n = size; n != 0; n--) {
+      head = (head + 1) & m_mask;
+      m_buffer[head] = *bp++;
+    }
+    *m_head = head;
+    return (size);
+  }
+
+private:
+  volatile uint16_t* m_head;	//!< Buffer head (put) index.
+  volatile uint16_t* m_tail;	//!< Buffer tail (get) index.
+  char* m_buffer;		//!< Buffer data.
+  uint16_t m_mask;		//!< Buffer index mask (size - 1).
+};
+
 #endif
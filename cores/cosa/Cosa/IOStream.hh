@@ -408,7 +408,7 @@ public:
   void print(const void *ptr, size_t size,
 	     Base base = dec, uint8_t max = 16)
   {
-    print((uint32_t) ptr, ptr, size, base, max);
+    print((uint32_t) (uintptr_t) ptr, ptr, size, base, max);
   }
 
   /**
@@ -417,7 +417,7 @@ public:
    */
   void print(void *ptr)
   {
-    print((unsigned int) ptr, hex);
+    print((uintptr_t) ptr, hex);
   }
 
   /**
@@ -427,7 +427,7 @@ public:
    */
   void print(const void *ptr)
   {
-    print((unsigned int) ptr, hex);
+    print((uintptr_t) ptr, hex);
   }
 
   /**
@@ -23,6 +23,8 @@
 #if !defined(BOARD_ATTINY)
 
 InputCapture* InputCapture::s_capture = NULL;
+InputCapture::Engine* InputCapture::s_engine = NULL;
+uint16_t InputCapture::s_overflow = 0;
 
 InputCapture::InputCapture(InterruptMode mode)
 {
@@ -66,9 +68,150 @@ InputCapture::clear()
   TIFR1 = _BV(ICF1);
 }
 
+bool
+InputCapture::Engine::read(uint32_t& time, bool& rising)
+{
+  uint8_t ix = m_get;
+  if (ix == m_put) return (false);
+  time = m_buf[ix];
+  rising = (time & 1);
+  m_get = (ix + 1) & m_mask;
+  return (true);
+}
+
+uint16_t
+InputCapture::Engine::decode()
+{
+  bool period_edge = (m_mode == ON_RISING_MODE);
+  uint16_t res = 0;
+  uint32_t time;
+  bool rising;
+
+  // The period is measured on the capture mode edge. With both edges
+  // the time to the other edge is accumulated when the period is done
+  while (read(time, rising)) {
+    if (m_both && (rising != period_edge)) {
+      if (m_valid) m_phase = time - m_edge;
+      continue;
+    }
+    if (m_valid) {
+      m_ticks += time - m_edge;
+      m_width += m_phase;
+      m_periods += 1;
+      res += 1;
+    }
+    m_phase = 0UL;
+    m_edge = time;
+    m_valid = true;
+  }
+  return (res);
+}
+
+uint32_t
+InputCapture::Engine::frequency() const
+{
+  if (m_ticks == 0) return (0UL);
+  return ((uint32_t) ((((float) F_CPU) * m_periods) / m_ticks + 0.5));
+}
+
+uint8_t
+InputCapture::Engine::duty() const
+{
+  if (m_ticks == 0 || !m_both) return (0);
+  uint8_t res = (uint8_t) ((m_width * 100.0) / m_ticks + 0.5);
+  return (m_mode == ON_RISING_MODE ? res : 100 - res);
+}
+
+int
+InputCapture::Engine::pulses(uint16_t* buf, uint8_t max, bool& rising)
+{
+  uint32_t time;
+  bool edge;
+  int res = 0;
+
+  // Continue from the latest edge of the previous call
+  if (!m_pulse_valid) {
+    if (!read(m_pulse_edge, edge)) return (0);
+    m_pulse_valid = true;
+  }
+  rising = (m_pulse_edge & 1);
+  while (res < max && read(time, edge)) {
+    uint32_t us = (time - m_pulse_edge) / I_CPU;
+    buf[res++] = (us > UINT16_MAX ? UINT16_MAX : us);
+    m_pulse_edge = time;
+  }
+  return (res);
+}
+
+void
+InputCapture::Engine::enable()
+{
+  synchronized {
+    // Normal mode, no prescale; start the extended time from zero
+    TCCR1A = 0;
+    TCCR1B = _BV(CS10);
+    mode(m_mode);
+    TCNT1 = 0;
+    s_overflow = 0;
+    m_put = 0;
+    m_get = 0;
+    m_overruns = 0;
+    m_pulse_valid = false;
+    s_engine = this;
+
+    // Enable input capture and overflow interrupt
+    TIFR1 = _BV(ICF1) | _BV(TOV1);
+    TIMSK1 |= (_BV(ICIE1) | _BV(TOIE1));
+  }
+}
+
+void
+InputCapture::Engine::disable()
+{
+  synchronized {
+    TIMSK1 &= ~(_BV(ICIE1) | _BV(TOIE1));
+    s_engine = NULL;
+  }
+}
+
 ISR(TIMER1_CAPT_vect)
 {
+  uint16_t icr = ICR1;
+
+  // Buffered capture; extend with overflow count. Adjust if the
+  // overflow is pending and the capture occurred after the overflow
+  InputCapture::Engine* engine = InputCapture::s_engine;
+  if (engine != NULL) {
+    uint16_t high = InputCapture::s_overflow;
+    if ((TIFR1 & _BV(TOV1)) && (icr < 0x8000)) high += 1;
+    uint32_t time = (((uint32_t) high) << 16) | icr;
+    uint8_t rising = (TCCR1B & _BV(ICES1)) != 0;
+    time = (time & ~1UL) | rising;
+
+    // Toggle edge select to capture both edges
+    if (engine->m_both) {
+      TCCR1B ^= _BV(ICES1);
+      TIFR1 = _BV(ICF1);
+    }
+
+    // Store timestamp; count overrun if buffer full
+    uint8_t ix = engine->m_put;
+    uint8_t next = (ix + 1) & engine->m_mask;
+    if (UNLIKELY(next == engine->m_get)) {
+      engine->m_overruns += 1;
+      return;
+    }
+    engine->m_buf[ix] = time;
+    engine->m_put = next;
+    return;
+  }
+
   if (UNLIKELY(InputCapture::s_capture == NULL)) return;
-  InputCapture::s_capture->on_interrupt(ICR1);
+  InputCapture::s_capture->on_interrupt(icr);
+}
+
+ISR(TIMER1_OVF_vect)
+{
+  InputCapture::s_overflow += 1;
 }
 #endif
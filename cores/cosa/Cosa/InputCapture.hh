@@ -44,6 +44,9 @@ public:
     ON_RISING_MODE
   } __attribute__((packed));
 
+  /** Buffered capture engine; see below. */
+  class Engine;
+
   /**
    * Construct input capture unit with given capture mode and
    * with no prescale. Pin is D8 on ATmega328 based boards.
@@ -135,6 +138,175 @@ public:
 
 private:
   static InputCapture* s_capture;
+  static Engine* s_engine;
+  static uint16_t s_overflow;
+  friend void TIMER1_CAPT_vect(void);
+  friend void TIMER1_OVF_vect(void);
+};
+
+/**
+ * Input capture engine. The capture timestamps are extended to 32-bit
+ * with the number of timer overflows and stored in a ring buffer
+ * directly by the interrupt service routine; there is no per-edge
+ * dispatch. Capture on both edges is supported by toggling the edge
+ * select after each capture. The period, frequency, duty cycle and
+ * pulse train widths are decoded from the buffer in the main loop.
+ *
+ * @section Limitations
+ * The timestamp resolution is two timer ticks; the least significant
+ * bit holds the edge (rising=1). The timestamps wrap after 2^32 system
+ * clock cycles (268 s at 16 MHz). Timestamps are dropped and counted
+ * when the buffer is full.
+ */
+class InputCapture::Engine : public InputCapture {
+public:
+  /**
+   * Construct input capture engine with given buffer and size
+   * (power of 2, max 128), capture mode and both edges flag.
+   * @param[in] buf timestamp buffer.
+   * @param[in] size number of timestamps in buffer.
+   * @param[in] mode capture mode (Default ON_RISING_MODE).
+   * @param[in] both capture both edges (Default false).
+   */
+  Engine(uint32_t* buf, uint8_t size,
+	 InterruptMode mode = ON_RISING_MODE,
+	 bool both = false) :
+    InputCapture(mode),
+    m_buf(buf),
+    m_mask(size - 1),
+    m_mode(mode),
+    m_both(both),
+    m_put(0),
+    m_get(0),
+    m_overruns(0),
+    m_pulse_valid(false)
+  {
+    reset();
+  }
+
+  /**
+   * Return number of buffered timestamps.
+   * @return number of timestamps.
+   * @note atomic
+   */
+  uint8_t available() const
+  {
+    uint8_t res;
+    synchronized res = (m_put - m_get) & m_mask;
+    return (res);
+  }
+
+  /**
+   * Read next timestamp from buffer. Return true(1) if available
+   * otherwise false(0).
+   * @param[out] time timestamp in system clock cycles.
+   * @param[out] rising edge.
+   * @return bool.
+   */
+  bool read(uint32_t& time, bool& rising);
+
+  /**
+   * Get number of dropped timestamps.
+   * @return number of overruns.
+   * @note atomic
+   */
+  uint16_t overruns() const
+  {
+    uint16_t res;
+    synchronized res = m_overruns;
+    return (res);
+  }
+
+  /**
+   * Reset measurement (period, frequency and duty cycle).
+   */
+  void reset()
+  {
+    m_valid = false;
+    m_ticks = 0UL;
+    m_width = 0UL;
+    m_phase = 0UL;
+    m_periods = 0;
+  }
+
+  /**
+   * Decode buffered timestamps and accumulate period and high time
+   * measurement since latest reset(). The period is measured on the
+   * capture mode edge. Returns number of periods decoded.
+   * @return number of periods.
+   */
+  uint16_t decode();
+
+  /**
+   * Get average period in system clock cycles; zero(0) if not
+   * measured.
+   * @return clock cycles.
+   */
+  uint32_t period() const
+  {
+    return (m_periods == 0 ? 0UL : m_ticks / m_periods);
+  }
+
+  /**
+   * Get frequency in Hz; zero(0) if not measured.
+   * @return frequency.
+   */
+  uint32_t frequency() const;
+
+  /**
+   * Get duty cycle in percent (high time of period); zero(0) if not
+   * measured. Requires capture of both edges.
+   * @return duty cycle.
+   */
+  uint8_t duty() const;
+
+  /**
+   * Decode buffered timestamps as a pulse train. The widths between
+   * successive edges are stored in the given buffer in micro-seconds
+   * (saturated at UINT16_MAX). The edge of the first timestamp is
+   * returned; the first width is high if rising. The latest edge is
+   * kept and the next call continues from it so that a long pulse
+   * train may be decoded with several calls. Returns number of
+   * widths.
+   * @param[in] buf width buffer.
+   * @param[in] max max number of widths.
+   * @param[out] rising edge of first timestamp.
+   * @return number of widths.
+   */
+  int pulses(uint16_t* buf, uint8_t max, bool& rising);
+
+  /**
+   * @override{Interrupt::Handler}
+   * Start timer and enable buffered input capture. The buffer,
+   * overflow count and pulse train decoding are reset.
+   * @note atomic
+   */
+  virtual void enable();
+
+  /**
+   * @override{Interrupt::Handler}
+   * Disable buffered input capture.
+   * @note atomic
+   */
+  virtual void disable();
+
+protected:
+  uint32_t* m_buf;		//!< Timestamp buffer.
+  const uint8_t m_mask;		//!< Buffer index mask.
+  const InterruptMode m_mode;	//!< Capture mode; period edge.
+  const bool m_both;		//!< Capture both edges.
+  volatile uint8_t m_put;	//!< Buffer put index.
+  volatile uint8_t m_get;	//!< Buffer get index.
+  uint16_t m_overruns;		//!< Number of dropped timestamps.
+  bool m_valid;			//!< Latest edges are valid.
+  uint32_t m_edge;		//!< Latest period edge.
+  uint32_t m_ticks;		//!< Accumulated periods (clock cycles).
+  uint32_t m_width;		//!< Accumulated period edge to other edge.
+  uint32_t m_phase;		//!< Period edge to other edge in period.
+  uint16_t m_periods;		//!< Number of accumulated periods.
+  bool m_pulse_valid;		//!< Latest pulse edge is valid.
+  uint32_t m_pulse_edge;	//!< Latest pulse edge (timestamp).
+
   friend void TIMER1_CAPT_vect(void);
 };
 
@@ -183,6 +183,222 @@ public:
     uint8_t m_mode;		//!< Text mode.
   };
 
+  /**
+   * Shadow buffer for character LCD device drivers. Records the
+   * desired screen and refreshes the display with only the changed
+   * character runs; rewrite of a dashboard with a single changed
+   * value costs a cursor move and a few data writes instead of a
+   * full screen. The shadow is itself an LCD::Device and may be used
+   * as the device of an LCD stream. The flush may be performed
+   * directly or spread over time with the Refresh periodic job.
+   *
+   * @section Limitations
+   * Output is only written to the display on flush(). Display
+   * scrolling and text flow right-to-left are not mirrored.
+   */
+  class Shadow : public Device {
+  public:
+    /** Max number of unchanged characters in a run before a cursor move. */
+    static const uint8_t GAP_MAX = 2;
+
+    /**
+     * Construct shadow buffer for given character display device with
+     * given dimensions. The buffer must hold 2 x width x height
+     * characters; desired and displayed screen.
+     * @param[in] dev character display device driver.
+     * @param[in] buf buffer for desired and displayed screen.
+     * @param[in] width of display, characters per line.
+     * @param[in] height of display, number of lines.
+     */
+    Shadow(Device* dev, char* buf, uint8_t width, uint8_t height) :
+      Device(),
+      WIDTH(width),
+      HEIGHT(height),
+      m_dev(dev),
+      m_screen(buf),
+      m_display(buf + width * height),
+      m_dx(0),
+      m_dy(0)
+    {
+      memset(buf, ' ', 2 * width * height);
+    }
+
+    /** Display width (characters per line). */
+    const uint8_t WIDTH;
+
+    /** Display height (lines). */
+    const uint8_t HEIGHT;
+
+    /**
+     * @override{LCD::Device}
+     * Start display device and clear shadow buffer. Returns true if
+     * successful otherwise false.
+     * @return boolean.
+     */
+    virtual bool begin();
+
+    /**
+     * @override{LCD::Device}
+     * Flush pending changes and stop display device. Returns true if
+     * successful otherwise false.
+     * @return boolean.
+     */
+    virtual bool end()
+    {
+      flush();
+      return (m_dev->end());
+    }
+
+    /**
+     * @override{LCD::Device}
+     * Turn display backlight on.
+     */
+    virtual void backlight_on()
+    {
+      m_dev->backlight_on();
+    }
+
+    /**
+     * @override{LCD::Device}
+     * Turn display backlight off.
+     */
+    virtual void backlight_off()
+    {
+      m_dev->backlight_off();
+    }
+
+    /**
+     * @override{LCD::Device}
+     * Set display contrast level.
+     * @param[in] level to set.
+     */
+    virtual void display_contrast(uint8_t level)
+    {
+      m_dev->display_contrast(level);
+    }
+
+    /**
+     * @override{LCD::Device}
+     * Turn display on.
+     */
+    virtual void display_on()
+    {
+      m_dev->display_on();
+    }
+
+    /**
+     * @override{LCD::Device}
+     * Turn display off.
+     */
+    virtual void display_off()
+    {
+      m_dev->display_off();
+    }
+
+    /**
+     * @override{LCD::Device}
+     * Clear shadow buffer and move cursor to home. The display is
+     * cleared on flush() with the changed characters only.
+     */
+    virtual void display_clear();
+
+    /**
+     * @override{LCD::Device}
+     * Set cursor position in shadow buffer to given position.
+     * @param[in] x.
+     * @param[in] y.
+     */
+    virtual void set_cursor(uint8_t x, uint8_t y);
+
+    /**
+     * @override{IOStream::Device}
+     * Write character to shadow buffer. Handles carriage-return-line-
+     * feed, back-space, alert, horizontal tab and form-feed. Returns
+     * character or EOF on error.
+     * @param[in] c character to write.
+     * @return character written or EOF(-1).
+     */
+    virtual int putchar(char c);
+
+    /**
+     * Write changed character runs to the display. At most the given
+     * number of characters are written (zero for no limit); the
+     * remaining changes are written on the next call. Returns number
+     * of characters written.
+     * @param[in] max number of characters to write (Default 0).
+     * @return number of characters written.
+     */
+    uint16_t flush(uint16_t max = 0);
+
+    /**
+     * Return true(1) if the shadow buffer has changes that are not
+     * written to the display otherwise false(0).
+     * @return bool.
+     */
+    bool is_dirty() const
+    {
+      return (memcmp(m_screen, m_display, WIDTH * HEIGHT) != 0);
+    }
+
+    /**
+     * Mark all characters as changed; the full screen is written on
+     * the next flush. Use after writing directly to the display device.
+     */
+    void invalidate();
+
+    /**
+     * Periodic flush of shadow buffer; spreads the refresh of the
+     * display over time with a limited number of characters per period.
+     */
+    class Refresh : public Periodic {
+    public:
+      /**
+       * Construct periodic flush of given shadow buffer with given
+       * scheduler, period and max number of characters per period.
+       * @param[in] shadow buffer to flush.
+       * @param[in] scheduler for periodic job.
+       * @param[in] period of flush.
+       * @param[in] max number of characters per flush (Default 0).
+       */
+      Refresh(Shadow* shadow, Job::Scheduler* scheduler,
+	      uint32_t period, uint16_t max = 0) :
+	Periodic(scheduler, period),
+	m_shadow(shadow),
+	m_max(max)
+      {}
+
+      /**
+       * @override{Job}
+       * Flush changes in shadow buffer.
+       */
+      virtual void run()
+      {
+	m_shadow->flush(m_max);
+      }
+
+    protected:
+      Shadow* m_shadow;		//!< Shadow buffer.
+      uint16_t m_max;		//!< Max number of characters per flush.
+    };
+
+  protected:
+    Device* m_dev;		//!< Display device driver.
+    char* m_screen;		//!< Desired screen.
+    char* m_display;		//!< Displayed screen.
+    uint8_t m_dx;		//!< Display device cursor position x.
+    uint8_t m_dy;		//!< Display device cursor position y.
+
+    /**
+     * Fill given line in shadow buffer with space from given position.
+     * @param[in] x position.
+     * @param[in] y line.
+     */
+    void clear(uint8_t x, uint8_t y)
+    {
+      memset(&m_screen[y * WIDTH + x], ' ', WIDTH - x);
+    }
+  };
+
   /**
    * Abstract LCD IO adapter to isolate communication specific
    * functions and allow access over software serial or hardware SPI.
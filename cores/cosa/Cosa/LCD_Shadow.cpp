@@ -0,0 +1,157 @@
+/**
+ * @file Cosa/LCD_Shadow.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/LCD.hh"
+
+bool
+LCD::Shadow::begin()
+{
+  // The display device is cleared on start
+  if (!m_dev->begin()) return (false);
+  memset(m_screen, ' ', 2 * WIDTH * HEIGHT);
+  m_x = 0;
+  m_y = 0;
+  m_dx = 0;
+  m_dy = 0;
+  return (true);
+}
+
+void
+LCD::Shadow::display_clear()
+{
+  memset(m_screen, ' ', WIDTH * HEIGHT);
+  m_x = 0;
+  m_y = 0;
+}
+
+void
+LCD::Shadow::set_cursor(uint8_t x, uint8_t y)
+{
+  if (x >= WIDTH) x = 0;
+  if (y >= HEIGHT) y = 0;
+  m_x = x;
+  m_y = y;
+}
+
+int
+LCD::Shadow::putchar(char c)
+{
+  // Check for special characters
+  if (c < ' ') {
+
+    // Carriage-return: move to start of line
+    if (c == '\r') {
+      m_x = 0;
+      return (c);
+    }
+
+    // New-line: clear line
+    if (c == '\n') {
+      set_cursor(0, m_y + 1);
+      clear(0, m_y);
+      return (c);
+    }
+
+    // Horizontal tab
+    if (c == '\t') {
+      uint8_t x = m_x + m_tab - (m_x % m_tab);
+      uint8_t y = m_y + (x >= WIDTH);
+      set_cursor(x, y);
+      return (c);
+    }
+
+    // Form-feed: clear the display
+    if (c == '\f') {
+      display_clear();
+      return (c);
+    }
+
+    // Back-space: move cursor back one step (if possible)
+    if (c == '\b') {
+      set_cursor(m_x - 1, m_y);
+      return (c);
+    }
+
+    // Alert: handled by the display device
+    if (c == '\a') {
+      m_dev->putchar(c);
+      return (c);
+    }
+  }
+
+  // Write character to shadow buffer
+  if (m_x == WIDTH) putchar('\n');
+  m_screen[m_y * WIDTH + m_x] = c;
+  m_x += 1;
+  return (c & 0xff);
+}
+
+uint16_t
+LCD::Shadow::flush(uint16_t max)
+{
+  uint16_t count = 0;
+
+  for (uint8_t y = 0; y < HEIGHT; y++) {
+    char* sp = &m_screen[y * WIDTH];
+    char* dp = &m_display[y * WIDTH];
+    uint8_t x = 0;
+    while (x < WIDTH) {
+      // Skip unchanged characters
+      if (sp[x] == dp[x]) {
+	x += 1;
+	continue;
+      }
+
+      // Find end of run; short gaps of unchanged characters are
+      // rewritten as they cost less than a cursor move
+      uint8_t last = x;
+      for (uint8_t i = x + 1; (i < WIDTH) && (i - last <= GAP_MAX + 1); i++)
+	if (sp[i] != dp[i]) last = i;
+      uint16_t len = last - x + 1;
+      if ((max != 0) && (count + len > max)) len = max - count;
+
+      // Move display cursor if needed and write the run
+      if ((x != m_dx) || (y != m_dy)) m_dev->set_cursor(x, y);
+      m_dev->write(sp + x, len);
+      memcpy(dp + x, sp + x, len);
+      count += len;
+      x += len;
+      m_dx = x;
+      m_dy = y;
+      if (count == max) goto done;
+    }
+  }
+
+ done:
+  // Restore display cursor position
+  if ((count != 0) && ((m_dx != m_x) || (m_dy != m_y))) {
+    m_dev->set_cursor(m_x, m_y);
+    m_dx = m_x;
+    m_dy = m_y;
+  }
+  return (count);
+}
+
+void
+LCD::Shadow::invalidate()
+{
+  for (uint16_t i = 0, n = WIDTH * HEIGHT; i < n; i++)
+    m_display[i] = ~m_screen[i];
+}
@@ -37,28 +37,46 @@
 #define PCIEN (_BV(PCIE0))
 #endif
 
-PinChangeInterrupt* PinChangeInterrupt::s_pin[Board::PCMSK_MAX] = { NULL };
+PinChangeInterrupt* PinChangeInterrupt::s_pin[Board::PCMSK_MAX][CHARBITS] = {
+  { NULL }
+};
 uint8_t PinChangeInterrupt::s_state[Board::PCMSK_MAX] = { 0 };
+uint8_t PinChangeInterrupt::s_timestamp[Board::PCMSK_MAX] = { 0 };
+uint32_t (*PinChangeInterrupt::s_micros)() = NULL;
 
 void
 PinChangeInterrupt::enable()
 {
-  // Enable in pin change mask register and add to list of handlers
+  // Enable in pin change mask register and add to handlers of the pin
+  uint8_t ix = port();
+  uint8_t pin = bit();
   synchronized {
-    *PCIMR() |= m_mask;
-    if (m_next == NULL) {
-      uint8_t ix = PCIMR() - &PCMSK0;
-      if (ix >= Board::PCMSK_MAX) ix = Board::PCMSK_MAX - 1;
-      m_next = s_pin[ix];
-      s_pin[ix] = this;
+    PinChangeInterrupt* handler = s_pin[ix][pin];
+    while (handler != NULL && handler != this) handler = handler->m_next;
+    if (handler == NULL) {
+      m_next = s_pin[ix][pin];
+      s_pin[ix][pin] = this;
     }
+    *PCIMR() |= m_mask;
   }
 }
 
 void
 PinChangeInterrupt::disable()
 {
-  synchronized *PCIMR() &= ~m_mask;
+  // Remove from handlers of the pin and disable if no other handlers
+  uint8_t ix = port();
+  uint8_t pin = bit();
+  synchronized {
+    PinChangeInterrupt** handler = &s_pin[ix][pin];
+    while (*handler != NULL && *handler != this)
+      handler = &(*handler)->m_next;
+    if (*handler != NULL) {
+      *handler = m_next;
+      m_next = NULL;
+    }
+    if (s_pin[ix][pin] == NULL) *PCIMR() &= ~m_mask;
+  }
 }
 
 void
@@ -113,15 +131,32 @@ PinChangeInterrupt::on_interrupt(uint8_t vec, uint8_t mask, uint8_t port)
   uint8_t new_state = port;
   uint8_t changed = (new_state ^ old_state) & mask;
 
-  // Find the interrupt handler for the changed value and check mode
-  for (PinChangeInterrupt* pin = s_pin[vec]; pin != NULL; pin = pin->m_next)
-    if ((pin->m_mask & changed)
-	&& ((pin->m_mode == ON_CHANGE_MODE)
-	    || pin->m_mode == ((pin->m_mask & new_state) == 0)))
-      pin->on_interrupt();
-
   // Save the new pin state
   s_state[vec] = new_state;
+
+  // Capture time of change once for all pins requiring it
+  uint32_t now = 0UL;
+  if (changed & s_timestamp[vec]) now = s_micros();
+
+  // Dispatch to the interrupt handlers of each changed pin; check mode
+  PinChangeInterrupt** handler = s_pin[vec];
+  for (uint8_t ix = 0; changed != 0; ix++, changed >>= 1) {
+    if ((changed & 0x0f) == 0) {
+      ix += 4;
+      changed >>= 4;
+    }
+    if ((changed & 0x01) == 0) continue;
+    PinChangeInterrupt* pin = handler[ix];
+    while (pin != NULL) {
+      PinChangeInterrupt* next = pin->m_next;
+      if ((pin->m_mode == ON_CHANGE_MODE)
+	  || pin->m_mode == ((pin->m_mask & new_state) == 0)) {
+	if (pin->m_mask & s_timestamp[vec]) pin->m_timestamp = now;
+	pin->on_interrupt();
+      }
+      pin = next;
+    }
+  }
 }
 
 #define PCINT_ISR(vec,pin)					\
@@ -28,7 +28,12 @@
 
 /**
  * Abstract interrupt pin. Allows interrupt handling on
- * the pin value changes.
+ * the pin value changes. The interrupt service routine dispatches
+ * directly to the handlers of each changed pin through a per-port
+ * table of handler lists; several handlers may be enabled on the same
+ * pin. The time of the pin change may be captured in the interrupt
+ * service routine (RTT::micros()). The capture is in a separate
+ * translation unit; RTT is only linked when timestamp() is used.
  */
 class PinChangeInterrupt : public IOPin, public Interrupt::Handler {
 public:
@@ -61,19 +66,44 @@ public:
 		     bool pullup = false) :
     IOPin((Board::DigitalPin) pin, INPUT_MODE, pullup),
     m_mode(mode),
+    m_timestamp(0UL),
     m_next(NULL)
   {}
 
+  /**
+   * Enable or disable capture of the time of the pin change in the
+   * interrupt service routine. Requires RTT. The capture is per pin
+   * and shared by the handlers of the pin.
+   * @param[in] flag enable capture.
+   * @note atomic
+   */
+  void timestamp(bool flag);
+
+  /**
+   * Get time of latest pin change in micro-seconds (RTT::micros()).
+   * @return micro-seconds.
+   * @note atomic
+   */
+  uint32_t timestamp() const
+  {
+    uint32_t res;
+    synchronized res = m_timestamp;
+    return (res);
+  }
+
   /**
    * @override{Interrupt::Handler}
-   * Enable interrupt pin change detection and interrupt handler.
+   * Enable interrupt pin change detection and add interrupt handler
+   * to the handlers of the pin.
    * @note atomic
    */
   virtual void enable();
 
   /**
    * @override{Interrupt::Handler}
-   * Disable interrupt pin change detection.
+   * Remove interrupt handler from the handlers of the pin. Disable
+   * interrupt pin change detection when there are no other handlers
+   * of the pin.
    * @note atomic
    */
   virtual void disable();
@@ -86,15 +116,49 @@ public:
   virtual void on_interrupt(uint16_t arg = 0) = 0;
 
 private:
-  static PinChangeInterrupt* s_pin[Board::PCMSK_MAX];
+  /** Pin change interrupt handler lists; per port and pin. */
+  static PinChangeInterrupt* s_pin[Board::PCMSK_MAX][CHARBITS];
+
+  /** Latest port state. */
   static uint8_t s_state[Board::PCMSK_MAX];
 
+  /** Pins with time capture; per port. */
+  static uint8_t s_timestamp[Board::PCMSK_MAX];
+
+  /** Time capture clock; set when time capture is enabled. */
+  static uint32_t (*s_micros)();
+
   /** Interrupt Mode. */
   InterruptMode m_mode;
 
-  /** Linked list of pin change interrupt handlers. */
+  /** Time of latest pin change (us). */
+  uint32_t m_timestamp;
+
+  /** Next interrupt handler of the pin. */
   PinChangeInterrupt* m_next;
 
+  /**
+   * Return port index of pin change mask register.
+   * @return index.
+   */
+  uint8_t port() const
+  {
+    uint8_t ix = PCIMR() - &PCMSK0;
+    if (ix >= Board::PCMSK_MAX) ix = Board::PCMSK_MAX - 1;
+    return (ix);
+  }
+
+  /**
+   * Return pin number in port; bit position of the pin mask.
+   * @return bit position.
+   */
+  uint8_t bit() const
+  {
+    uint8_t res = 0;
+    for (uint8_t mask = m_mask; mask > 1; mask >>= 1) res++;
+    return (res);
+  }
+
   /**
    * Map interrupt source: Check which pin(s) are the source of the
    * pin change interrupt and call the corresponding interrupt handler
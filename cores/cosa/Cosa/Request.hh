@@ -0,0 +1,94 @@
+/**
+ * @file Cosa/Request.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_REQUEST_HH
+#define COSA_REQUEST_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/Linkage.hh"
+
+/**
+ * Asynchronous device request. Requests are posted to a device
+ * request queue (Head) and performed in order by the device interrupt
+ * service routine. A request is pending while it is attached to the
+ * queue. Completion is signaled with an event to the request target
+ * with the request as event environment. Device requests should
+ * sub-class and add the request parameters.
+ */
+class Request : public Link {
+public:
+  /**
+   * Construct request with given completion event target.
+   * @param[in] target completion event handler (Default NULL).
+   */
+  Request(Event::Handler* target = NULL) :
+    Link(),
+    m_target(target),
+    m_count(0)
+  {}
+
+  /**
+   * Return true(1) if the request is queued or in progress
+   * otherwise false(0).
+   * @return bool.
+   */
+  bool is_pending() const
+  {
+    return (m_succ != this);
+  }
+
+  /**
+   * Return number of bytes transferred or negative error code.
+   * @return number of bytes or negative error code.
+   */
+  int count() const
+  {
+    return (m_count);
+  }
+
+protected:
+  Event::Handler* m_target;	//!< Completion event target.
+  volatile int m_count;		//!< Number of bytes or error code.
+
+  /**
+   * Append request to the given queue. The request must not be
+   * pending.
+   * @param[in] queue request queue.
+   */
+  void enqueue(Head* queue)
+  {
+    m_count = 0;
+    queue->attach(this);
+  }
+
+  /**
+   * Complete the request; remove from the queue and push an event
+   * with the given type to the target. Called from the interrupt
+   * service routine when the request has been performed.
+   * @param[in] type event type.
+   */
+  void complete(uint8_t type)
+  {
+    detach();
+    if (m_target != NULL) Event::push(type, m_target, this);
+  }
+};
+
+#endif
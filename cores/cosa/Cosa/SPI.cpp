@@ -51,7 +51,12 @@ SPI::Driver::Driver(Board::DigitalPin cs, Pulse pulse,
 SPI::SPI() :
   m_list(NULL),
   m_dev(NULL),
-  m_busy(false)
+  m_busy(false),
+  m_queue(),
+  m_vp(NULL),
+  m_next(NULL),
+  m_last(NULL),
+  m_ix(0)
 {
   // Initiate the SPI data direction for master mode
   // The SPI/SS pin must be an output pin in master mode
@@ -281,6 +286,14 @@ void
 SPI::release()
 {
   synchronized {
+#if defined(SPDR)
+    // Continue with posted transfers
+    if (!m_queue.is_empty()) {
+      dispatch();
+      return;
+    }
+#endif
+
     // Power down
     SPI::powerdown();
 
@@ -293,6 +306,95 @@ SPI::release()
   }
 }
 
+#if defined(SPDR)
+bool
+SPI::post(Transfer* trans)
+{
+  // Sanity check the transfer; must have at least one byte to transfer
+  if (UNLIKELY(trans->is_pending() || (trans->m_vec == NULL))) return (false);
+  if (UNLIKELY(iovec_size(trans->m_vec) == 0)) return (false);
+
+  // Append to the queue and start if the bus is not acquired
+  synchronized {
+    trans->enqueue(&m_queue);
+    if (!m_busy) {
+      m_busy = true;
+      SPI::powerup();
+      for (SPI::Driver* dev = m_list; dev != NULL; dev = dev->m_next)
+	if (dev->m_irq != NULL) dev->m_irq->disable();
+      dispatch();
+    }
+  }
+  return (true);
+}
+
+void
+SPI::dispatch()
+{
+  // Set device settings and select the device
+  Transfer* trans = (Transfer*) m_queue.succ();
+  m_dev = trans->m_dev;
+  SPCR = m_dev->m_spcr | _BV(SPIE);
+  SPSR = m_dev->m_spsr;
+  begin();
+
+  // Start with the first non-empty buffer; post() rejects empty vectors
+  m_vp = trans->m_vec;
+  m_ix = 0;
+  m_next = (uint8_t*) m_vp->buf;
+  m_last = m_next + m_vp->size;
+  if (m_next == m_last) isr_next();
+  SPDR = (m_ix < trans->m_rx) ? *m_next : 0xff;
+}
+
+bool
+SPI::isr_next()
+{
+  while (m_vp->buf != NULL) {
+    m_vp += 1;
+    m_ix += 1;
+    if (m_vp->buf == NULL) return (false);
+    m_next = (uint8_t*) m_vp->buf;
+    m_last = m_next + m_vp->size;
+    if (m_next != m_last) return (true);
+  }
+  return (false);
+}
+
+ISR(SPI_STC_vect)
+{
+  SPI::Transfer* trans = (SPI::Transfer*) spi.m_queue.succ();
+  uint8_t data = SPDR;
+
+  // Store received byte and step to the next byte to send
+  if (LIKELY(spi.m_next != spi.m_last)) {
+    if (spi.m_ix >= trans->m_rx) *spi.m_next = data;
+    spi.m_next += 1;
+    trans->m_count += 1;
+    if ((spi.m_next != spi.m_last) || spi.isr_next()) {
+      SPDR = (spi.m_ix < trans->m_rx) ? *spi.m_next : 0xff;
+      return;
+    }
+  }
+
+  // Transfer completed; deselect device and signal the target
+  spi.end();
+  trans->complete(Event::COMMAND_COMPLETED_TYPE);
+
+  // Start the next transfer or release the bus
+  if (!spi.m_queue.is_empty()) {
+    spi.dispatch();
+    return;
+  }
+  SPCR = 0;
+  SPI::powerdown();
+  spi.m_busy = false;
+  spi.m_dev = NULL;
+  for (SPI::Driver* dev = spi.m_list; dev != NULL; dev = dev->m_next)
+    if (dev->m_irq != NULL) dev->m_irq->enable();
+}
+#endif
+
 void
 SPI::Driver::set_clock(Clock rate)
 {
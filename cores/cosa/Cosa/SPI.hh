@@ -26,6 +26,7 @@
 #include "Cosa/OutputPin.hh"
 #include "Cosa/Interrupt.hh"
 #include "Cosa/Event.hh"
+#include "Cosa/Request.hh"
 #include "Cosa/IOStream.hh"
 
 /**
@@ -174,7 +175,62 @@ public:
     uint8_t m_spsr;		//!< SPI/SPSR hardware status register.
 #endif
     friend class SPI;
+#if !defined(USIDR)
+    friend void SPI_STC_vect(void);
+#endif
+  };
+
+#if !defined(USIDR)
+  /**
+   * Asynchronous SPI transfer; exchange of a null terminated io
+   * vector with a device. The buffers before the given read index
+   * are written (received data is discarded), the buffers from the
+   * read index are read (0xff is sent). Transfers are posted to the
+   * transfer queue and streamed by the SPI transfer complete
+   * interrupt service routine; the device chip select and settings
+   * are sequenced between transfers. Completion is signaled with an
+   * Event::COMMAND_COMPLETED_TYPE and the count is the number of
+   * bytes transferred. Best suited for slow clock rates
+   * and long transfers where the CPU would otherwise wait for each
+   * byte.
+   */
+  class Transfer : public Request {
+  public:
+    /**
+     * Construct transfer for given device driver and completion
+     * event target.
+     * @param[in] dev device driver.
+     * @param[in] target completion event handler (Default NULL).
+     */
+    Transfer(Driver* dev, Event::Handler* target = NULL) :
+      Request(target),
+      m_dev(dev),
+      m_vec(NULL),
+      m_rx(0)
+    {}
+
+    /**
+     * Set null terminated io vector for the transfer and index of the
+     * first buffer to read. Must not be called while pending.
+     * @param[in] vec null terminated io vector.
+     * @param[in] rx index of first read buffer (Default 255, write only).
+     */
+    void set(const iovec_t* vec, uint8_t rx = 255)
+    {
+      m_vec = vec;
+      m_rx = rx;
+    }
+
+  protected:
+    Driver* m_dev;		//!< Device driver.
+    const iovec_t* m_vec;	//!< Null terminated io vector.
+    uint8_t m_rx;		//!< Index of first read buffer.
+
+    /** Allow access. */
+    friend class SPI;
+    friend void SPI_STC_vect(void);
   };
+#endif
 
   /**
    * Construct serial peripheral interface for master.
@@ -211,9 +267,32 @@ public:
 
   /**
    * Release the SPI device driver. Enable SPI interrupt sources.
+   * Posted transfers are started when the device driver is released.
    */
   void release();
 
+#if !defined(USIDR)
+  /**
+   * Post given transfer to the transfer queue. The queue is started
+   * directly if the bus is not acquired, otherwise when the bus is
+   * released. Return true(1) if successful otherwise false(0); the
+   * transfer is already pending, has no io vector or the io vector
+   * is empty (no bytes to transfer).
+   * @param[in] trans transfer.
+   * @return bool.
+   */
+  bool post(Transfer* trans);
+
+  /**
+   * Return true(1) if there are pending transfers otherwise false(0).
+   * @return bool.
+   */
+  bool is_queued() const
+  {
+    return (!m_queue.is_empty());
+  }
+#endif
+
   /**
    * Mark the beginning of a transfer block. Select the device by
    * asserting the chip select pin according to the pulse pattern.
@@ -445,6 +524,31 @@ private:
   Driver* m_list;		//!< List of attached device drivers.
   Driver* m_dev;		//!< Current device driver.
   volatile bool m_busy;		//!< Current device state.
+#if !defined(USIDR)
+  Head m_queue;			//!< Transfer queue.
+  const iovec_t* m_vp;		//!< Current transfer buffer.
+  uint8_t* m_next;		//!< Next byte in buffer.
+  uint8_t* m_last;		//!< End of buffer.
+  uint8_t m_ix;			//!< Current transfer buffer index.
+
+  /**
+   * Set hardware and chip select for the first transfer in queue and
+   * start the transfer. Called with interrupts disabled and the bus
+   * acquired.
+   */
+  void dispatch();
+
+  /**
+   * Step to next non-empty buffer in the current transfer. Return
+   * true(1) if there is a buffer otherwise false(0). Part of the SPI
+   * ISR state machine.
+   * @return bool.
+   */
+  bool isr_next();
+
+  /** Interrupt Service Routine. */
+  friend void SPI_STC_vect(void);
+#endif
 };
 
 /**
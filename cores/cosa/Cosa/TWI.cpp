@@ -33,14 +33,8 @@ TWI twi  __attribute__ ((weak));
 #endif
 
 void
-TWI::acquire(TWI::Driver* dev)
+TWI::enable()
 {
-  // Acquire the device driver. Wait is busy. Synchronized update
-  uint8_t key = lock(m_busy);
-
-  // Set the current device driver
-  m_dev = dev;
-
   // Power up the module
   powerup();
 
@@ -50,6 +44,17 @@ TWI::acquire(TWI::Driver* dev)
   // Set clock prescale and bit rate
   bit_mask_clear(TWSR, _BV(TWPS0) | _BV(TWPS1));
   TWBR = m_freq;
+}
+
+void
+TWI::acquire(TWI::Driver* dev)
+{
+  // Acquire the device driver. Wait is busy. Synchronized update
+  uint8_t key = lock(m_busy);
+
+  // Set the current device driver
+  m_dev = dev;
+  enable();
   TWCR = IDLE_CMD;
   unlock(key);
 }
@@ -60,15 +65,54 @@ TWI::release()
   // Check if an asynchronious read/write was issued
   if (UNLIKELY((m_dev == NULL) || (m_dev->is_async()))) return;
 
-  // Put into idle state
+  // Put into idle state or continue with posted transactions
+  bool idle = true;
   synchronized {
-    m_dev = NULL;
-    m_busy = false;
-    TWCR = 0;
+    if (!m_queue.is_empty()) {
+      dispatch();
+      idle = false;
+    }
+    else {
+      m_dev = NULL;
+      m_busy = false;
+      TWCR = 0;
+    }
   }
 
   // Power down the module
-  powerdown();
+  if (idle) powerdown();
+}
+
+bool
+TWI::post(Transaction* trans)
+{
+  // Sanity check the transaction; must have a write or read phase
+  if (UNLIKELY(trans->is_pending())) return (false);
+  if (UNLIKELY((trans->m_vec[Transaction::HEADER_IX].size == 0)
+	       && (trans->m_vec[Transaction::WRITE_IX].size == 0)
+	       && (trans->m_vec[Transaction::READ_IX].size == 0)))
+    return (false);
+
+  // Append to the queue and start if the bus is not acquired
+  synchronized {
+    trans->enqueue(&m_queue);
+    if (!m_busy) {
+      m_busy = true;
+      dispatch();
+    }
+  }
+  return (true);
+}
+
+void
+TWI::dispatch()
+{
+  Transaction* trans = (Transaction*) m_queue.succ();
+  bool write = ((trans->m_vec[Transaction::HEADER_IX].size != 0)
+		|| (trans->m_vec[Transaction::WRITE_IX].size != 0));
+  m_chained = true;
+  enable();
+  isr_request(trans, write ? WRITE_OP : READ_OP);
 }
 
 bool
@@ -129,6 +173,70 @@ TWI::read_request(void* buf, size_t size)
   return (request(READ_OP));
 }
 
+void
+TWI::isr_request(Transaction* trans, uint8_t op)
+{
+  iovec_t* vp = m_vec;
+  if (op == WRITE_OP) {
+    iovec_arg(vp,
+	      trans->m_vec[Transaction::HEADER_IX].buf,
+	      trans->m_vec[Transaction::HEADER_IX].size);
+    iovec_arg(vp,
+	      trans->m_vec[Transaction::WRITE_IX].buf,
+	      trans->m_vec[Transaction::WRITE_IX].size);
+  }
+  else {
+    iovec_arg(vp,
+	      trans->m_vec[Transaction::READ_IX].buf,
+	      trans->m_vec[Transaction::READ_IX].size);
+  }
+  iovec_end(vp);
+  m_dev = trans->m_dev;
+  request(op);
+}
+
+void
+TWI::isr_chain(bool error)
+{
+  Transaction* trans = (Transaction*) m_queue.succ();
+
+  // Continue with the read phase; repeated start
+  if (!error
+      && (m_state == MT_STATE)
+      && (trans->m_vec[Transaction::READ_IX].size != 0)) {
+    isr_request(trans, READ_OP);
+    return;
+  }
+
+  // Complete the transaction and signal the target
+  trans->m_count = error ? EIO : m_count;
+  trans->complete(error ? Event::ERROR_TYPE : Event::COMMAND_COMPLETED_TYPE);
+
+  // Release the bus after an error
+  if (UNLIKELY(error)) {
+    TWCR = STOP_CMD;
+    loop_until_bit_is_clear(TWCR, TWSTO);
+  }
+
+  // Start the next transaction; repeated start
+  if (!m_queue.is_empty()) {
+    dispatch();
+    return;
+  }
+
+  // Queue is empty; stop, release the bus and power down as release()
+  if (!error) {
+    TWCR = STOP_CMD;
+    loop_until_bit_is_clear(TWCR, TWSTO);
+  }
+  m_state = IDLE_STATE;
+  m_chained = false;
+  m_dev = NULL;
+  m_busy = false;
+  TWCR = 0;
+  powerdown();
+}
+
 int
 TWI::await_completed()
 {
@@ -152,6 +260,12 @@ TWI::isr_start(State state, uint8_t ix)
 void
 TWI::isr_stop(State state, uint8_t type)
 {
+  // Check for transaction queue
+  if (m_chained) {
+    isr_chain(state == TWI::ERROR_STATE);
+    return;
+  }
+
   TWCR = TWI::STOP_CMD;
   loop_until_bit_is_clear(TWCR, TWSTO);
   if (UNLIKELY(state == TWI::ERROR_STATE)) m_count = -1;
@@ -161,6 +275,10 @@ TWI::isr_stop(State state, uint8_t type)
   if (m_dev->is_async() || m_status == SR_STOP) {
     m_dev->on_completion(type, m_count);
     m_dev = NULL;
+    if (!m_queue.is_empty() && (m_status != SR_STOP)) {
+      dispatch();
+      return;
+    }
     m_busy = false;
     TWCR = 0;
   }
@@ -201,6 +319,10 @@ ISR(TWI_vect)
     break;
   case TWI::ARB_LOST:
     // Lost arbitration
+    if (twi.m_chained) {
+      twi.isr_chain(true);
+      break;
+    }
     TWCR = TWI::IDLE_CMD;
     twi.m_state = TWI::ERROR_STATE;
     twi.m_count = -1;
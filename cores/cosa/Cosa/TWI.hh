@@ -26,6 +26,7 @@
 #include "Cosa/USI/TWI.hh"
 #else
 #include "Cosa/Event.hh"
+#include "Cosa/Request.hh"
 #include <avr/power.h>
 
 /**
@@ -199,6 +200,92 @@ public:
     friend void TWI_vect(void);
   };
 
+  /**
+   * TWI transaction; write and/or read request to a device. The write
+   * (header and buffer) and the read are performed as a single bus
+   * transaction with repeated start. Transactions are posted to the
+   * transaction queue and executed by the interrupt service routine;
+   * queued transactions are chained with repeated start and the bus
+   * is released when the queue is empty. Completion is signaled with
+   * an Event::COMMAND_COMPLETED_TYPE (or Event::ERROR_TYPE). The
+   * count is the number of bytes read (or written if there is no read
+   * phase) or EIO(-5) if the transaction failed.
+   */
+  class Transaction : public Request {
+  public:
+    /**
+     * Construct transaction for given device driver and completion
+     * event target.
+     * @param[in] dev device driver.
+     * @param[in] target completion event handler (Default NULL).
+     */
+    Transaction(Driver* dev, Event::Handler* target = NULL) :
+      Request(target),
+      m_dev(dev)
+    {
+      for (uint8_t ix = 0; ix < VEC_MAX; ix++) {
+	m_vec[ix].buf = NULL;
+	m_vec[ix].size = 0;
+      }
+    }
+
+    /**
+     * Set write phase with given byte header/command and optional
+     * buffer. Must not be called while pending.
+     * @param[in] header to write before buffer.
+     * @param[in] buf pointer to buffer (Default NULL).
+     * @param[in] size number of bytes (Default 0).
+     */
+    void write(uint8_t header, void* buf = NULL, size_t size = 0)
+    {
+      m_header = header;
+      m_vec[HEADER_IX].buf = &m_header;
+      m_vec[HEADER_IX].size = sizeof(header);
+      m_vec[WRITE_IX].buf = buf;
+      m_vec[WRITE_IX].size = size;
+    }
+
+    /**
+     * Set write phase with given buffer. Must not be called while
+     * pending.
+     * @param[in] buf pointer to buffer.
+     * @param[in] size number of bytes.
+     */
+    void write(void* buf, size_t size)
+    {
+      m_vec[HEADER_IX].size = 0;
+      m_vec[WRITE_IX].buf = buf;
+      m_vec[WRITE_IX].size = size;
+    }
+
+    /**
+     * Set read phase with given buffer. The read follows the write
+     * phase with repeated start. Must not be called while pending.
+     * @param[in] buf pointer to buffer.
+     * @param[in] size number of bytes.
+     */
+    void read(void* buf, size_t size)
+    {
+      m_vec[READ_IX].buf = buf;
+      m_vec[READ_IX].size = size;
+    }
+
+  protected:
+    /** Index in io-vector for header, write and read buffers. */
+    static const uint8_t HEADER_IX = 0;
+    static const uint8_t WRITE_IX = 1;
+    static const uint8_t READ_IX = 2;
+    static const uint8_t VEC_MAX = 3;
+
+    Driver* m_dev;		//!< Device driver.
+    iovec_t m_vec[VEC_MAX];	//!< Header, write and read buffers.
+    uint8_t m_header;		//!< Header/command byte.
+
+    /** Allow access. */
+    friend class TWI;
+    friend void TWI_vect(void);
+  };
+
   /**
    * Construct two-wire instance. This is actually a single-ton on
    * current supported hardware, i.e. there can only be one unit.
@@ -212,7 +299,9 @@ public:
     m_count(0),
     m_dev(NULL),
     m_freq(((F_CPU / DEFAULT_FREQ) - 16) / 2),
-    m_busy(false)
+    m_busy(false),
+    m_queue(),
+    m_chained(false)
   {
     for (uint8_t ix = 0; ix < VEC_MAX; ix++) {
       m_vec[ix].buf = 0;
@@ -233,6 +322,26 @@ public:
    */
   void release();
 
+  /**
+   * Post given transaction to the transaction queue. The queue is
+   * started directly if the bus is not acquired, otherwise when the
+   * bus is released. Return true(1) if successful otherwise false(0);
+   * the transaction is already pending or has no write or read phase.
+   * @param[in] trans transaction.
+   * @return bool.
+   */
+  bool post(Transaction* trans);
+
+  /**
+   * Return true(1) if there are pending transactions otherwise
+   * false(0).
+   * @return bool.
+   */
+  bool is_queued() const
+  {
+    return (!m_queue.is_empty());
+  }
+
   /**
    * Issue a write data request to the current driver. Return
    * true(1) if successful otherwise false(0).
@@ -470,6 +579,19 @@ private:
   Driver* m_dev;
   uint8_t m_freq;
   volatile bool m_busy;
+  Head m_queue;
+  volatile bool m_chained;
+
+  /**
+   * Power up the hardware and set pullup resistors and bus frequency.
+   */
+  void enable();
+
+  /**
+   * Start transaction queue; the bus should be acquired. Called with
+   * interrupts disabled.
+   */
+  void dispatch();
 
   /**
    * Start block transfer. Setup internal buffer pointers.
@@ -504,6 +626,24 @@ private:
    */
   void isr_stop(State state, uint8_t type = Event::NULL_TYPE);
 
+  /**
+   * Initiate write or read phase of given transaction. Sets the
+   * transaction device driver as current. Part of the TWI ISR state
+   * machine.
+   * @param[in] trans transaction.
+   * @param[in] op slave operation.
+   */
+  void isr_request(Transaction* trans, uint8_t op);
+
+  /**
+   * Continue with the read phase of the current transaction, or
+   * complete the transaction and start the next in queue with
+   * repeated start. The bus is released when the queue is empty.
+   * Part of the TWI ISR state machine.
+   * @param[in] error transaction failed.
+   */
+  void isr_chain(bool error);
+
   /**
    * Initiate a request to the device. Return true(1) if successful
    * otherwise false(0).
@@ -319,7 +319,12 @@ inline uint8_t lock() __attribute__((always_inline));
 inline uint8_t lock()
 {
   uint8_t key = SREG;
+#if defined(__AVR_ARCH__)
   __asm__ __volatile__("cli" ::: "memory");
+#else
+  // Host build; no interrupts
+  __asm__ __volatile__("" ::: "memory");
+#endif
   return (key);
 }
 
@@ -460,6 +465,7 @@ inline void iovec_end(iovec_t* &vp)
 inline uint16_t swap(uint16_t value) __attribute__((always_inline));
 inline uint16_t swap(uint16_t value)
 {
+#if defined(__AVR_ARCH__)
   asm volatile("mov __tmp_reg__, %A0" 	"\n\t"
 	       "mov %A0, %B0" 		"\n\t"
 	       "mov %B0, __tmp_reg__" 	"\n\t"
@@ -467,6 +473,9 @@ inline uint16_t swap(uint16_t value)
 	       : "0" (value)
 	       );
   return (value);
+#else
+  return (__builtin_bswap16(value));
+#endif
 }
 
 /**
@@ -553,6 +562,7 @@ inline void swap(int16_t* dest, const int16_t* src, size_t size)
 inline uint32_t swap(uint32_t value) __attribute__((always_inline));
 inline uint32_t swap(uint32_t value)
 {
+#if defined(__AVR_ARCH__)
   asm volatile("mov __tmp_reg__, %A0" 	"\n\t"
 	       "mov %A0, %D0" 		"\n\t"
 	       "mov %D0, __tmp_reg__" 	"\n\t"
@@ -563,6 +573,9 @@ inline uint32_t swap(uint32_t value)
 	       : "0" (value)
 	       );
   return (value);
+#else
+  return (__builtin_bswap32(value));
+#endif
 }
 
 /**
@@ -20,6 +20,7 @@
 
 #include "Cosa/Board.hh"
 #include "Cosa/UART.hh"
+#include "Cosa/Watchdog.hh"
 
 #if defined(BOARD_ATTINY)
 // Default is serial output only (UAT)
@@ -126,6 +127,32 @@ UART::putchar(char c)
   return (c & 0xff);
 }
 
+int
+UART::write(const void* buf, size_t size)
+{
+  // Fallback to character write when the buffer is not an IOBuffer
+  if (UNLIKELY(!m_oring.is_attached()))
+    return (IOStream::Device::write(buf, size));
+
+  // Flag that transitter is used
+  m_idle = false;
+
+  // Fill the buffer with as much as possible and enable the transmitter
+  const char* bp = (const char*) buf;
+  size_t n = size;
+  while (n != 0) {
+    size_t count = m_oring.write(bp, n);
+    if (count == 0) {
+      yield();
+      continue;
+    }
+    *UCSRnB() |= _BV(UDRIE0);
+    bp += count;
+    n -= count;
+  }
+  return (size);
+}
+
 int
 UART::flush()
 {
@@ -146,6 +173,56 @@ UART::flush()
   return (0);
 }
 
+void
+UART::empty()
+{
+  synchronized {
+    m_ibuf->empty();
+    frame_reset();
+  }
+}
+
+bool
+UART::framing(Framing mode)
+{
+  // Framed receive mode requires direct access to the input buffer
+  if (UNLIKELY((mode != NO_FRAMING) && !m_iring.is_attached()))
+    return (false);
+  synchronized {
+    m_framing = mode;
+    m_ibuf->empty();
+    frame_reset();
+  }
+  return (true);
+}
+
+int
+UART::recv(void* buf, size_t size, uint32_t ms)
+{
+  if (UNLIKELY(m_framing == NO_FRAMING)) return (EINVAL);
+
+  // Wait for a frame
+  uint32_t start = Watchdog::millis();
+  while (m_frame_put == m_frame_get) {
+    if ((ms != 0) && (Watchdog::since(start) > ms)) return (ETIME);
+    yield();
+  }
+
+  // Copy the frame from the input buffer and remove from queue
+  uint16_t len = m_frame_len[m_frame_get];
+  int res = len;
+  if (UNLIKELY(len > size)) {
+    res = EMSGSIZE;
+    while (len--) m_iring.getchar();
+  }
+  else {
+    char* bp = (char*) buf;
+    while (len--) *bp++ = m_iring.getchar();
+  }
+  m_frame_get = (m_frame_get + 1) & FRAME_QUEUE_MASK;
+  return (res);
+}
+
 void
 UART::powerup()
 {
@@ -207,7 +284,7 @@ UART::powerdown()
 void
 UART::on_udre_interrupt()
 {
-  int c = m_obuf->getchar();
+  int c = m_oring.is_attached() ? m_oring.getchar() : m_obuf->getchar();
   if (c != IOStream::EOF) {
     *UDRn() = c;
     *UCSRnA() |= _BV(TXC0);
@@ -220,7 +297,138 @@ UART::on_udre_interrupt()
 void
 UART::on_rx_interrupt()
 {
-  m_ibuf->putchar(*UDRn());
+  // Read status before data; errors apply to the received character
+  uint8_t status = *UCSRnA();
+  uint8_t c = *UDRn();
+  if (UNLIKELY(status & (_BV(FE0) | _BV(DOR0) | _BV(UPE0)))) {
+    if (status & _BV(FE0)) m_stats.frame_errors += 1;
+    if (status & _BV(DOR0)) m_stats.overruns += 1;
+    if (status & _BV(UPE0)) m_stats.parity_errors += 1;
+    if (m_framing != NO_FRAMING) {
+      frame_discard();
+      if (status & (_BV(FE0) | _BV(UPE0))) return;
+    }
+  }
+
+  // Decode frame or append to input buffer
+  if (m_framing != NO_FRAMING) {
+    frame_receive(c);
+    return;
+  }
+  int res;
+  if (m_iring.is_attached())
+    res = m_iring.putchar(c);
+  else
+    res = m_ibuf->putchar(c);
+  if (UNLIKELY(res == IOStream::EOF)) m_stats.overflows += 1;
+}
+
+void
+UART::frame_reset()
+{
+  m_frame_put = 0;
+  m_frame_get = 0;
+  m_frame_mark = m_iring.is_attached() ? m_iring.mark() : 0;
+  m_frame_size = 0;
+  m_frame_state = 0;
+  m_frame_code = 0;
+}
+
+void
+UART::frame_receive(uint8_t c)
+{
+  // SLIP; frame delimiter and escaped characters
+  if (m_framing == SLIP_FRAMING) {
+    if (c == SLIP_END) {
+      frame_end();
+      return;
+    }
+    if (m_frame_state & FRAME_DISCARD) return;
+    if (m_frame_state & FRAME_ESCAPE) {
+      m_frame_state &= ~FRAME_ESCAPE;
+      if (c == SLIP_ESC_END)
+	c = SLIP_END;
+      else if (c == SLIP_ESC_ESC)
+	c = SLIP_ESC;
+      else {
+	frame_discard();
+	return;
+      }
+    }
+    else if (c == SLIP_ESC) {
+      m_frame_state |= FRAME_ESCAPE;
+      return;
+    }
+    frame_put(c);
+    return;
+  }
+
+  // COBS; zero delimiter and code bytes with the distance to next zero
+  if (c == 0) {
+    if (m_frame_code != 0) frame_discard();
+    frame_end();
+    return;
+  }
+  if (m_frame_state & FRAME_DISCARD) return;
+  if (m_frame_code != 0) {
+    m_frame_code -= 1;
+    frame_put(c);
+    return;
+  }
+  if (m_frame_state & FRAME_ZERO) {
+    frame_put(0);
+    if (m_frame_state & FRAME_DISCARD) return;
+  }
+  m_frame_code = c - 1;
+  if (c == 0xff)
+    m_frame_state &= ~FRAME_ZERO;
+  else
+    m_frame_state |= FRAME_ZERO;
+}
+
+void
+UART::frame_put(uint8_t c)
+{
+  if (UNLIKELY(m_iring.putchar(c) == IOStream::EOF)) {
+    m_stats.overflows += 1;
+    frame_discard();
+    return;
+  }
+  m_frame_size += 1;
+}
+
+void
+UART::frame_end()
+{
+  // Record the frame boundary; drop the frame if the queue is full
+  if ((m_frame_state & FRAME_DISCARD) == 0 && (m_frame_size != 0)) {
+    uint8_t next = (m_frame_put + 1) & FRAME_QUEUE_MASK;
+    if (UNLIKELY(next == m_frame_get)) {
+      m_iring.rewind(m_frame_mark);
+      m_stats.dropped += 1;
+    }
+    else {
+      m_frame_len[m_frame_put] = m_frame_size;
+      m_frame_put = next;
+    }
+  }
+
+  // Start of next frame
+  m_frame_mark = m_iring.mark();
+  m_frame_size = 0;
+  m_frame_state = 0;
+  m_frame_code = 0;
+}
+
+void
+UART::frame_discard()
+{
+  if (m_frame_state & FRAME_DISCARD) return;
+  m_iring.rewind(m_frame_mark);
+  m_frame_size = 0;
+  m_frame_state = FRAME_DISCARD;
+  m_frame_code = 0;
+  m_stats.dropped += 1;
 }
 
 #define UART_ISR(vec,nr)			\
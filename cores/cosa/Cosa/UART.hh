@@ -49,12 +49,28 @@ extern Soft::UAT uart;
 #include "Cosa/Types.h"
 #include "Cosa/Serial.hh"
 #include "Cosa/IOStream.hh"
+#include "Cosa/IOBuffer.hh"
 #include "Cosa/Board.hh"
 
+// Default number of received frames in framed receive mode
+#ifndef COSA_UART_FRAME_QUEUE_MAX
+# define COSA_UART_FRAME_QUEUE_MAX 4
+#endif
+
 /**
  * Basic UART device handler with external buffering. IOStream
  * devices may be piped with the IOBuffer class. The UART class
- * requires an input- and output IOBuffer instance.
+ * requires an input- and output IOBuffer instance. When constructed
+ * with IOBuffer instances the interrupt handlers access the buffers
+ * directly (inline ring operations) and write() fills the output
+ * buffer in chunks.
+ *
+ * The receive interrupt handler counts frame, data overrun and parity
+ * errors, and input buffer overflow. In framed receive mode (SLIP or
+ * COBS) the interrupt handler decodes the received frames into the
+ * input buffer and records the frame boundaries. Frames with errors
+ * are dropped and the receiver resynchronises on the next frame
+ * delimiter. Whole frames are read with recv().
  */
 class UART : public Serial {
 public:
@@ -62,6 +78,33 @@ public:
   static const uint16_t RX_BUFFER_MAX = COSA_UART_RX_BUFFER_MAX;
   static const uint16_t TX_BUFFER_MAX = COSA_UART_TX_BUFFER_MAX;
 
+  /** Number of received frames in framed receive mode (power of 2). */
+  static const uint8_t FRAME_QUEUE_MAX = COSA_UART_FRAME_QUEUE_MAX;
+
+  /** Receive modes. */
+  enum Framing {
+    NO_FRAMING = 0,		//!< Byte stream.
+    SLIP_FRAMING = 1,		//!< SLIP (RFC 1055) frames.
+    COBS_FRAMING = 2		//!< COBS frames with zero delimiter.
+  } __attribute__((packed));
+
+  /** SLIP special characters. */
+  enum {
+    SLIP_END = 0xc0,		//!< Frame delimiter.
+    SLIP_ESC = 0xdb,		//!< Escape character.
+    SLIP_ESC_END = 0xdc,	//!< Escaped frame delimiter.
+    SLIP_ESC_ESC = 0xdd		//!< Escaped escape character.
+  };
+
+  /** Receiver error counters. */
+  struct stats_t {
+    uint16_t frame_errors;	//!< Number of frame errors (FE).
+    uint16_t overruns;		//!< Number of data overruns (DOR).
+    uint16_t parity_errors;	//!< Number of parity errors (UPE).
+    uint16_t overflows;		//!< Number of input buffer overflows.
+    uint16_t dropped;		//!< Number of dropped frames (framed mode).
+  };
+
   /**
    * Construct serial port handler for given UART.
    * @param[in] port number.
@@ -74,8 +117,36 @@ public:
     m_sfr(Board::UART(port)),
     m_ibuf(ibuf),
     m_obuf(obuf),
-    m_idle(true)
+    m_idle(true),
+    m_framing(NO_FRAMING)
+  {
+    memset(&m_stats, 0, sizeof(m_stats));
+    frame_reset();
+    uart[port] = this;
+  }
+
+  /**
+   * Construct serial port handler for given UART with given input
+   * and output buffers. The interrupt handlers use direct ring access
+   * to the buffers.
+   * @param[in] port number.
+   * @param[in] ibuf input buffer.
+   * @param[in] obuf output buffer.
+   */
+  template <uint16_t IBUF_MAX, uint16_t OBUF_MAX>
+  UART(uint8_t port, IOBuffer<IBUF_MAX>* ibuf, IOBuffer<OBUF_MAX>* obuf) :
+    Serial(),
+    m_port(port),
+    m_sfr(Board::UART(port)),
+    m_ibuf(ibuf),
+    m_obuf(obuf),
+    m_idle(true),
+    m_framing(NO_FRAMING)
   {
+    memset(&m_stats, 0, sizeof(m_stats));
+    m_iring.attach(ibuf);
+    m_oring.attach(obuf);
+    frame_reset();
     uart[port] = this;
   }
 
@@ -108,6 +179,28 @@ public:
    */
   virtual int putchar(char c);
 
+  /**
+   * @override{IOStream::Device}
+   * Write data from buffer with given size to serial port output
+   * buffer. The output buffer is filled in chunks and the transmitter
+   * is enabled once per chunk. Returns number of bytes written.
+   * @param[in] buf buffer to write.
+   * @param[in] size number of bytes to write.
+   * @return number of bytes written.
+   */
+  virtual int write(const void* buf, size_t size);
+
+  /**
+   * @override{IOStream::Device}
+   * Write data from io vector to serial port output buffer.
+   * @param[in] vec io vector with buffers to write.
+   * @return number of bytes written.
+   */
+  virtual int write(const iovec_t* vec)
+  {
+    return (IOStream::Device::write(vec));
+  }
+
   /**
    * @override{IOStream::Device}
    * Peek at next character from serial port input buffer. Returns
@@ -153,11 +246,69 @@ public:
    * @override{IOStream::Device}
    * Empty output device buffers.
    */
-  virtual void empty()
+  virtual void empty();
+
+  /**
+   * Return receiver error counters.
+   * @return counters.
+   */
+  const stats_t& stats() const
+  {
+    return (m_stats);
+  }
+
+  /**
+   * Reset receiver error counters.
+   */
+  void reset_stats()
+  {
+    synchronized {
+      memset(&m_stats, 0, sizeof(m_stats));
+    }
+  }
+
+  /**
+   * Set receive mode. The input buffer is emptied. Framed receive
+   * mode requires an IOBuffer input buffer. Return true(1) if
+   * successful otherwise false(0).
+   * @param[in] mode receive mode.
+   * @return true(1) if successful otherwise false(0).
+   */
+  bool framing(Framing mode);
+
+  /**
+   * Return receive mode.
+   * @return mode.
+   */
+  Framing framing() const
   {
-    m_ibuf->empty();
+    return (m_framing);
   }
 
+  /**
+   * Return number of received frames available in framed receive
+   * mode.
+   * @return frames.
+   */
+  int frames() const
+  {
+    return ((m_frame_put - m_frame_get) & FRAME_QUEUE_MASK);
+  }
+
+  /**
+   * Receive decoded frame in framed receive mode and store into given
+   * buffer with given maximum size. Returns the number of bytes in
+   * the frame or a negative error code; EINVAL(-22) if not in framed
+   * receive mode, ETIME(-62) on timeout and EMSGSIZE(-90) if the
+   * frame does not fit the buffer (the frame is discarded). The
+   * time out is measured with the watchdog clock.
+   * @param[in] buf buffer to store frame.
+   * @param[in] size maximum number of bytes to receive.
+   * @param[in] ms maximum time out period (Default 0, blocking).
+   * @return number of bytes received or negative error code.
+   */
+  int recv(void* buf, size_t size, uint32_t ms = 0L);
+
   /**
    * @override{Serial}
    * Powerup and start UART for given baudrate and format. Returns
@@ -194,7 +345,29 @@ protected:
   volatile uint8_t* const m_sfr;	//!< Special Function Register Pointer.
   IOStream::Device* m_ibuf;		//!< Input Buffer/Device.
   IOStream::Device* m_obuf;		//!< Output Buffer/Device.
+  IORing m_iring;			//!< Input Buffer direct access.
+  IORing m_oring;			//!< Output Buffer direct access.
   bool m_idle;				//!< Flag idle mode.
+  Framing m_framing;			//!< Receive mode.
+  stats_t m_stats;			//!< Receiver error counters.
+
+  /** Frame queue index mask. */
+  static const uint8_t FRAME_QUEUE_MASK = FRAME_QUEUE_MAX - 1;
+
+  /** Frame receive state flags. */
+  enum {
+    FRAME_DISCARD = 0x01,		//!< Discard until delimiter.
+    FRAME_ESCAPE = 0x02,		//!< SLIP escape received.
+    FRAME_ZERO = 0x04			//!< COBS zero before next block.
+  };
+
+  volatile uint8_t m_frame_put;		//!< Frame queue put index.
+  volatile uint8_t m_frame_get;		//!< Frame queue get index.
+  uint16_t m_frame_len[FRAME_QUEUE_MAX]; //!< Frame queue; frame sizes.
+  uint16_t m_frame_mark;		//!< Input buffer head at frame start.
+  uint16_t m_frame_size;		//!< Size of current frame.
+  uint8_t m_frame_state;		//!< Frame receive state flags.
+  uint8_t m_frame_code;			//!< COBS bytes left in block.
 
   /**
    * Serial port references. Only uart0 is predefined (reference to global
@@ -259,6 +432,38 @@ protected:
    */
   virtual void on_rx_interrupt();
 
+  /**
+   * Reset frame receive state and queue. Called with interrupts
+   * disabled.
+   */
+  void frame_reset();
+
+  /**
+   * Decode given received character in framed receive mode. Called
+   * from the receive interrupt handler.
+   * @param[in] c received character.
+   */
+  void frame_receive(uint8_t c);
+
+  /**
+   * Append decoded character to current frame. The frame is dropped
+   * on input buffer overflow.
+   * @param[in] c character.
+   */
+  void frame_put(uint8_t c);
+
+  /**
+   * Complete the current frame on delimiter and record the frame
+   * boundary. Empty and discarded frames are ignored.
+   */
+  void frame_end();
+
+  /**
+   * Drop the current frame; remove the received part from the input
+   * buffer and discard until the next delimiter.
+   */
+  void frame_discard();
+
   /**
    * @override{UART}
    * Common UART transmit completed interrupt handler.
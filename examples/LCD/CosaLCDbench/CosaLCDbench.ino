@@ -36,6 +36,7 @@
 
 // HD44780 driver built-in adapters
 // HD44780::Port4b port;
+// HD44780::Port4bRW port;
 // HD44780::SR3W port;
 // HD44780::SR3WSPI port;
 // HD44780::SR4W port;
@@ -67,6 +68,7 @@ HD44780 lcd(&port);
 // #include <HD44780.h>
 // #include <ST7920.h>
 // HD44780::Port4b port;
+// HD44780::Port4bRW port;
 // ST7920 lcd(&port);
 
 // #include <PCD8544.h>
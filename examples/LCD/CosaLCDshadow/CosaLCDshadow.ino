@@ -0,0 +1,79 @@
+/**
+ * @file CosaLCDshadow.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demonstrate the LCD shadow buffer; a status screen is rewritten at
+ * 5 Hz and only the changed characters are written to the display by
+ * a periodic refresh job.
+ *
+ * @section Circuit
+ * See HD44780.hh for description of LCD adapter circuits.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/RTT.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/Periodic.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/AnalogPin.hh"
+#include "Cosa/IOStream.hh"
+#include <HD44780.h>
+
+// HD44780 driver and shadow buffer
+HD44780::Port4b port;
+HD44780 lcd(&port);
+char buf[2 * 16 * 2];
+LCD::Shadow shadow(&lcd, buf, 16, 2);
+
+// Connect IOStream to shadow buffer
+IOStream cout(&shadow);
+
+// Refresh display every 64 ms with at most 8 characters
+Watchdog::Scheduler scheduler;
+LCD::Shadow::Refresh refresh(&shadow, &scheduler, 64, 8);
+
+class Status : public Periodic {
+public:
+  Status() : Periodic(&scheduler, 200), m_count(0) {}
+
+  virtual void run()
+  {
+    cout << clear;
+    cout << PSTR("count: ") << m_count++ << endl;
+    cout << PSTR("A0: ") << AnalogPin::sample(Board::A0);
+  }
+
+private:
+  uint16_t m_count;
+};
+
+Status status;
+
+void setup()
+{
+  RTT::begin();
+  Watchdog::begin();
+  shadow.begin();
+  refresh.start();
+  status.start();
+}
+
+void loop()
+{
+  Event::service();
+}
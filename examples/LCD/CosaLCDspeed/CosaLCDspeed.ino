@@ -46,6 +46,7 @@
 
 // HD44780 driver built-in adapters
 // HD44780::Port4b port;
+// HD44780::Port4bRW port;
 // HD44780::SR3W port;
 // HD44780::SR3WSPI port;
 // HD44780::SR4W port;
@@ -77,6 +78,7 @@ HD44780 lcd(&port);
 // #include <HD44780.h>
 // #include <ST7920.h>
 // HD44780::Port4b port;
+// HD44780::Port4bRW port;
 // ST7920 lcd(&port);
 
 // #include <PCD8544.h>
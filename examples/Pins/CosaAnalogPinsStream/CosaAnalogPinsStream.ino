@@ -0,0 +1,90 @@
+/**
+ * @file CosaAnalogPinsStream.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa demonstration of continuous sampling of an analog pin set.
+ * The pins are sampled at 1 KHz and the average of each buffer half
+ * (32 scans) is printed together with the number of overruns.
+ *
+ * @section Circuit
+ * @code
+ *
+ * (A0)-----------------<
+ * (A1)-----------------<
+ * (A2)-----------------<
+ * (A3)-----------------<
+ *
+ * @endcode
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/AnalogPins.hh"
+#include "Cosa/Board.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+// Analog pin vector for pin set. Note: use program memory
+const Board::AnalogPin pins[] __PROGMEM = {
+  Board::A0,
+  Board::A1,
+  Board::A2,
+  Board::A3
+};
+
+// Latest sample values (not used when streaming) and stream buffer
+static const uint8_t SCANS = 32;
+uint16_t values[membersof(pins)];
+uint16_t buffer[2 * SCANS * membersof(pins)];
+
+// Pin set with buffer handler; print average of each pin
+class Sampler : public AnalogPins {
+public:
+  Sampler() : AnalogPins(pins, values, membersof(pins)) {}
+
+  virtual void on_event(uint8_t type, uint16_t value)
+  {
+    if (type != Event::RECEIVE_COMPLETED_TYPE) return;
+    const uint16_t* buf = (const uint16_t*) value;
+    uint32_t sum[membersof(pins)] = { 0 };
+    for (uint8_t scan = 0; scan < SCANS; scan++)
+      for (uint8_t i = 0; i < membersof(pins); i++)
+	sum[i] += *buf++;
+    stream_release((const uint16_t*) value);
+    for (uint8_t i = 0; i < membersof(pins); i++)
+      trace << sum[i] / SCANS << ' ';
+    trace << overruns() << endl;
+  }
+};
+
+Sampler sampler;
+
+void setup()
+{
+  uart.begin(57600);
+  trace.begin(&uart, PSTR("CosaAnalogPinsStream: started"));
+  Watchdog::begin();
+  ASSERT(sampler.stream_begin(buffer, SCANS, 1000));
+  TRACE(sampler.stream_rate());
+  TRACE(sampler.stream_period());
+}
+
+void loop()
+{
+  Event::service();
+}
@@ -0,0 +1,66 @@
+/**
+ * @file CosaInputCaptureEngine.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa demonstration of the buffered Input Capture engine. Measures
+ * frequency and duty cycle of the signal on the input capture pin
+ * (ICP1/D8). Connect for instance a PWM pin (D5) to D8.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/InputCapture.hh"
+#include "Cosa/PWMPin.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+// Timestamp buffer and capture engine on both edges
+uint32_t buf[64];
+InputCapture::Engine capture(buf, membersof(buf),
+			     InputCapture::ON_RISING_MODE,
+			     true);
+
+// Test signal
+PWMPin pwm(Board::PWM1);
+
+void setup()
+{
+  uart.begin(57600);
+  trace.begin(&uart, PSTR("CosaInputCaptureEngine: started"));
+  trace << PSTR("ICP1 - D8") << endl;
+  Watchdog::begin();
+  InputCapture::begin();
+  pwm.begin();
+  pwm.set(64);
+  capture.enable();
+}
+
+void loop()
+{
+  // Decode the captured edges every 100 ms and print once per second
+  capture.reset();
+  for (uint8_t i = 0; i < 10; i++) {
+    Watchdog::delay(100);
+    capture.decode();
+  }
+  trace << capture.frequency() << PSTR(" hz, ")
+	<< capture.duty() << PSTR(" %, ")
+	<< capture.period() / I_CPU << PSTR(" us, ")
+	<< capture.overruns() << PSTR(" overruns")
+	<< endl;
+}
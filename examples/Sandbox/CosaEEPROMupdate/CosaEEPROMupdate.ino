@@ -0,0 +1,93 @@
+/**
+ * @file CosaEEPROMupdate.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demonstration of asynchronous EEPROM updates. A configuration
+ * block is posted to the internal EEPROM and the time to post and to
+ * complete (completion event) is measured together with the number
+ * of bytes programmed. Unchanged bytes are skipped.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/EEPROM.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/RTT.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+// Configuration block in EEPROM and in memory
+static const size_t CONFIG_MAX = 64;
+uint8_t config[CONFIG_MAX] EEMEM;
+uint8_t block[CONFIG_MAX];
+
+// EEPROM access object
+EEPROM eeprom;
+
+// Record completion time
+class Completion : public Event::Handler {
+public:
+  Completion() : m_done(false), m_stop(0L) {}
+
+  virtual void on_event(uint8_t type, uint16_t value)
+  {
+    UNUSED(value);
+    if (type != Event::WRITE_COMPLETED_TYPE) return;
+    m_stop = RTT::micros();
+    m_done = true;
+  }
+
+  bool m_done;
+  uint32_t m_stop;
+};
+
+Completion completion;
+EEPROM::Device::Update update(&completion);
+
+void setup()
+{
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaEEPROMupdate: started"));
+  RTT::begin();
+  update.set(config, block, sizeof(block));
+}
+
+void loop()
+{
+  static uint8_t n = 0;
+
+  // Change some of the bytes in the block; every second run unchanged
+  if ((n & 1) == 0)
+    for (size_t i = 0; i < sizeof(block); i += 4) block[i] = n + i;
+  n += 1;
+
+  // Post the update and wait for the completion event
+  completion.m_done = false;
+  uint32_t start = RTT::micros();
+  ASSERT(eeprom.post(&update));
+  uint32_t posted = RTT::micros() - start;
+  while (!completion.m_done) {
+    Event event;
+    Event::queue.await(&event);
+    event.dispatch();
+  }
+  trace << PSTR("post = ") << posted
+	<< PSTR(" us, completed = ") << completion.m_stop - start
+	<< PSTR(" us, programmed = ") << update.count()
+	<< endl;
+  sleep(2);
+}
@@ -0,0 +1,96 @@
+/**
+ * @file CosaSPIqueue.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demonstration and verification of the SPI transfer queue; chip
+ * select sequencing and device settings between posted transfers.
+ * The debug pin marks the posting of the transfers and is pulsed
+ * when the completion events have been received. The CPU is free
+ * while the bytes are transferred by the interrupt service routine.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/SPI.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/OutputPin.hh"
+
+SPI::Driver dev1(Board::D2, SPI::ACTIVE_LOW, SPI::DIV128_CLOCK, 0);
+SPI::Driver dev2(Board::D3, SPI::ACTIVE_HIGH, SPI::DIV8_CLOCK, 1);
+
+OutputPin debug(Board::D6, 1);
+
+// Count completion events
+class Completion : public Event::Handler {
+public:
+  Completion() : m_count(0) {}
+
+  virtual void on_event(uint8_t type, uint16_t value)
+  {
+    UNUSED(value);
+    if (type == Event::COMMAND_COMPLETED_TYPE) m_count += 1;
+  }
+
+  uint8_t m_count;
+};
+
+Completion completion;
+
+// Command header and data block (write), and response (read)
+uint8_t cmd[] = { 0x40, 0x00, 0x00, 0x00, 0x00, 0x95 };
+uint8_t data[32];
+uint8_t response[8];
+
+iovec_t vec1[3];
+iovec_t vec2[2];
+SPI::Transfer trans1(&dev1, &completion);
+SPI::Transfer trans2(&dev2, &completion);
+
+void setup()
+{
+  iovec_t* vp = vec1;
+  iovec_arg(vp, cmd, sizeof(cmd));
+  iovec_arg(vp, response, sizeof(response));
+  iovec_end(vp);
+  trans1.set(vec1, 1);
+  vp = vec2;
+  iovec_arg(vp, data, sizeof(data));
+  iovec_end(vp);
+  trans2.set(vec2);
+}
+
+void loop()
+{
+  // Sleep to synch with logic analyser
+  sleep(5);
+
+  // Post transfers; command-response (dev1@125KHz) and block (dev2@2MHz)
+  debug.clear();
+  completion.m_count = 0;
+  spi.post(&trans1);
+  spi.post(&trans2);
+  debug.set();
+
+  // Wait for the completion events
+  while (completion.m_count != 2) {
+    Event event;
+    Event::queue.await(&event);
+    event.dispatch();
+  }
+  debug.clear();
+  debug.set();
+}
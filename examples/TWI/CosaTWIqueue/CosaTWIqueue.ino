@@ -0,0 +1,120 @@
+/**
+ * @file CosaTWIqueue.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa demonstration of the TWI transaction queue. A round of
+ * register reads from a HMC5883L magnetometer, a MPU6050 motion
+ * sensor and a BMP085 pressure sensor (GY-87 10DOF module) is posted
+ * to the queue and executed by the TWI interrupt service routine with
+ * repeated start. The completion events are handled in the event loop.
+ *
+ * @section Circuit
+ * The Arduino analog pins 4 (SDA) and 5 (SCL) are used for I2C/TWI
+ * connection.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/TWI.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/RTT.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+// Sensor devices
+TWI::Driver hmc5883l(0x1e);
+TWI::Driver mpu6050(0x68);
+TWI::Driver bmp085(0x77);
+
+// Sensor round; collects the register reads
+class Round : public Event::Handler {
+public:
+  Round() :
+    m_compass(&hmc5883l, this),
+    m_motion(&mpu6050, this),
+    m_pressure(&bmp085, this),
+    m_pending(0)
+  {
+    m_compass.write(0x0a);
+    m_compass.read(m_id, sizeof(m_id));
+    m_motion.write(0x75);
+    m_motion.read(&m_who, sizeof(m_who));
+    m_pressure.write(0xd0);
+    m_pressure.read(&m_chip, sizeof(m_chip));
+  }
+
+  void start()
+  {
+    m_start = RTT::micros();
+    m_pending = 3;
+    twi.post(&m_compass);
+    twi.post(&m_motion);
+    twi.post(&m_pressure);
+  }
+
+  virtual void on_event(uint8_t type, uint16_t value)
+  {
+    TWI::Transaction* trans = (TWI::Transaction*) value;
+    if (type != Event::COMMAND_COMPLETED_TYPE)
+      trace << PSTR("error:") << trans->count() << endl;
+    if (--m_pending != 0) return;
+    uint32_t us = RTT::micros() - m_start;
+    trace << PSTR("round:") << us << PSTR(" us") << endl;
+    trace.print(m_id, sizeof(m_id), IOStream::hex);
+    trace << PSTR("who=") << hex << m_who
+	  << PSTR(", chip=") << hex << m_chip
+	  << endl;
+  }
+
+  bool is_done() const
+  {
+    return (m_pending == 0);
+  }
+
+private:
+  TWI::Transaction m_compass;
+  TWI::Transaction m_motion;
+  TWI::Transaction m_pressure;
+  uint8_t m_id[3];
+  uint8_t m_who;
+  uint8_t m_chip;
+  uint8_t m_pending;
+  uint32_t m_start;
+};
+
+Round sensors;
+
+void setup()
+{
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaTWIqueue: started"));
+  TRACE(sizeof(TWI::Transaction));
+  Watchdog::begin();
+  RTT::begin();
+}
+
+void loop()
+{
+  sensors.start();
+  while (!sensors.is_done()) {
+    Event event;
+    Event::queue.await(&event);
+    event.dispatch();
+  }
+  sleep(2);
+}
@@ -24,6 +24,9 @@
 
 Canvas::Context Canvas::context;
 
+/** Max number of bitmap columns per glyph strip. */
+static const uint8_t STRIP_MAX = 16;
+
 Canvas::color16_t
 Canvas::shade(color16_t color, uint8_t scale)
 {
@@ -70,33 +73,16 @@ Canvas::draw_bitmap(uint16_t x, uint16_t y, const uint8_t* bp,
 		    uint16_t width, uint16_t height,
 		    uint8_t scale)
 {
-  if (scale == 1) {
-    for (uint16_t i = 0; i < height; i += 8) {
-      for (uint16_t j = 0; j < width; j++) {
-	uint8_t bits = pgm_read_byte(bp++);
-	if (bits == 0xff) {
-	  draw_vertical_line(x + j, y + i, CHARBITS);
-	}
-	else {
-	  for (uint8_t k = 0; k < 8; k++) {
-	    if (bits == 0) break;
-	    if (bits & 1) draw_pixel(x + j, y + k + i);
-	    bits >>= 1;
-	  }
-	}
-      }
-    }
-  }
-  else {
-    for (uint16_t i = 0; i < height; i += 8) {
-      for (uint16_t j = 0; j < width; j++) {
-	uint8_t bits = pgm_read_byte(bp++);
-	for (uint8_t k = 0; k < 8; k++) {
-	  if (bits == 0) break;
-	  if (bits & 1) fill_rect(x + j*scale, y + (k+i)*scale, scale, scale);
-	  bits >>= 1;
-	}
-      }
+  // Draw as glyph strips of 8 rows; copy columns from program memory
+  for (uint16_t i = 0; i < height; i += CHARBITS) {
+    uint8_t rows = (height - i < CHARBITS) ? height - i : CHARBITS;
+    for (uint16_t j = 0; j < width; ) {
+      uint8_t buf[STRIP_MAX];
+      uint8_t n = (width - j < STRIP_MAX) ? width - j : STRIP_MAX;
+      memcpy_P(buf, bp, n);
+      bp += n;
+      draw_glyph(x + j*scale, y + i*scale, buf, n, rows, scale);
+      j += n;
     }
   }
 }
@@ -120,22 +106,21 @@ Canvas::draw_icon(uint16_t x, uint16_t y, const uint8_t* bp, uint8_t scale)
 void
 Canvas::draw_image(uint16_t x, uint16_t y, Image* image)
 {
-  color16_t saved = set_pen_color(0);
   uint16_t width = image->WIDTH;
   uint16_t height = image->HEIGHT;
+  window_begin(x, y, width, height);
   for (uint16_t i = 0; i < height; i++) {
     color16_t buf[Image::BUFFER_MAX];
     size_t count;
     for (uint16_t j = 0; j < width; j += count) {
-      count = (width - j > Image::BUFFER_MAX) ? Image::BUFFER_MAX : width - j;
-      image->read(buf, Image::BUFFER_MAX);
-      for (uint8_t k = 0; k < count; k++) {
-	set_pen_color(buf[k]);
-	draw_pixel(x + j, y + i);
-      }
+      count = ((size_t) (width - j) > Image::BUFFER_MAX) ?
+	Image::BUFFER_MAX : width - j;
+      if (!image->read(buf, count)) goto error;
+      window_write(buf, count);
     }
   }
-  set_pen_color(saved);
+ error:
+  window_end();
 }
 
 void
@@ -180,16 +165,23 @@ Canvas::draw_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
   dy = dist(y0, y1);
   int16_t err = dx / 2;
   int8_t ystep = (y0 < y1) ? 1 : -1;
+
+  // Accumulate runs along the major axis and fill each run
+  uint16_t start = x0;
   for (; x0 <= x1; x0++) {
-    if (steep) {
-      draw_pixel(y0, x0);
-    } else {
-      draw_pixel(x0, y0);
-    }
     err -= dy;
-    if (err < 0) {
-      y0 += ystep;
-      err += dx;
+    if ((err < 0) || (x0 == x1)) {
+      uint16_t length = x0 - start + 1;
+      if (steep) {
+	fill_rect(y0, start, 1, length);
+      } else {
+	fill_rect(start, y0, length, 1);
+      }
+      start = x0 + 1;
+      if (err < 0) {
+	y0 += ystep;
+	err += dx;
+      }
     }
   }
 }
@@ -249,15 +241,20 @@ Canvas::draw_circle(uint16_t x, uint16_t y, uint16_t radius)
   int16_t f = 1 - radius;
   int16_t dx = 1;
   int16_t dy = -2 * radius;
-  int8_t rx = 0;
-  int8_t ry = radius;
+  int16_t rx = 0;
+  int16_t ry = radius;
+  int16_t start = 1;
 
   draw_pixel(x, y + radius);
   draw_pixel(x, y - radius);
   draw_pixel(x + radius, y);
   draw_pixel(x - radius, y);
+
+  // Accumulate runs with the same distance and fill octant spans
   while (rx < ry) {
     if (f >= 0) {
+      if (rx >= start) draw_circle_spans(x, y, start, rx, ry);
+      start = rx + 1;
       ry--;
       dy += 2;
       f += dy;
@@ -265,15 +262,24 @@ Canvas::draw_circle(uint16_t x, uint16_t y, uint16_t radius)
     rx++;
     dx += 2;
     f += dx;
-    draw_pixel(x + rx, y + ry);
-    draw_pixel(x - rx, y + ry);
-    draw_pixel(x + rx, y - ry);
-    draw_pixel(x - rx, y - ry);
-    draw_pixel(x + ry, y + rx);
-    draw_pixel(x - ry, y + rx);
-    draw_pixel(x + ry, y - rx);
-    draw_pixel(x - ry, y - rx);
   }
+  if (rx >= start) draw_circle_spans(x, y, start, rx, ry);
+}
+
+void
+Canvas::draw_circle_spans(uint16_t x, uint16_t y,
+			  uint16_t first, uint16_t last,
+			  uint16_t r)
+{
+  uint16_t length = last - first + 1;
+  fill_rect(x + first, y + r, length, 1);
+  fill_rect(x - last, y + r, length, 1);
+  fill_rect(x + first, y - r, length, 1);
+  fill_rect(x - last, y - r, length, 1);
+  fill_rect(x + r, y + first, 1, length);
+  fill_rect(x - r, y + first, 1, length);
+  fill_rect(x + r, y - last, 1, length);
+  fill_rect(x - r, y - last, 1, length);
 }
 
 void
@@ -385,6 +391,96 @@ Canvas::draw_char(uint16_t x, uint16_t y, char c)
   set_pen_color(saved);
 }
 
+void
+Canvas::draw_glyph(uint16_t x, uint16_t y, const uint8_t* bp,
+		   uint8_t width, uint8_t height,
+		   uint8_t scale)
+{
+  // Write runs of text and canvas color to window in opaque text mode
+  if (get_text_mode() == OPAQUE_TEXT_MODE) {
+    const color16_t fg = get_pen_color();
+    const color16_t bg = get_canvas_color();
+    window_begin(x, y, width * scale, height * scale);
+    for (uint8_t mask = 1; height != 0; height--, mask <<= 1) {
+      for (uint8_t s = 0; s < scale; s++) {
+	uint8_t j = 0;
+	while (j < width) {
+	  bool set = ((bp[j] & mask) != 0);
+	  uint8_t n = 1;
+	  while ((j + n < width) && (((bp[j + n] & mask) != 0) == set)) n++;
+	  window_fill(set ? fg : bg, n * scale);
+	  j += n;
+	}
+      }
+    }
+    window_end();
+    return;
+  }
+
+  // Fill vertical spans of set bits in each column
+  uint8_t mask = (height < CHARBITS) ? _BV(height) - 1 : 0xff;
+  for (uint8_t j = 0; j < width; j++, x += scale) {
+    uint8_t bits = *bp++ & mask;
+    uint8_t k = 0;
+    while (bits != 0) {
+      while ((bits & 1) == 0) {
+	bits >>= 1;
+	k += 1;
+      }
+      uint8_t n = 0;
+      while (bits & 1) {
+	bits >>= 1;
+	n += 1;
+      }
+      fill_rect(x, y + k * scale, scale, n * scale);
+      k += n;
+    }
+  }
+}
+
+void
+Canvas::window_begin(uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+{
+  m_window.x = x;
+  m_window.y = y;
+  m_window.width = width;
+  m_window.height = height;
+  m_window_pos.x = 0;
+  m_window_pos.y = 0;
+}
+
+void
+Canvas::window_write(const color16_t* buf, size_t count)
+{
+  // Fill runs of the same color
+  while (count != 0) {
+    uint16_t n = 1;
+    while ((n < count) && (buf[n].rgb == buf[0].rgb)) n++;
+    window_fill(buf[0], n);
+    buf += n;
+    count -= n;
+  }
+}
+
+void
+Canvas::window_fill(color16_t color, uint16_t count)
+{
+  // Fill the run row by row within the window
+  color16_t saved = set_pen_color(color);
+  while ((count != 0) && (m_window_pos.y < m_window.height)) {
+    uint16_t n = m_window.width - m_window_pos.x;
+    if (n > count) n = count;
+    fill_rect(m_window.x + m_window_pos.x, m_window.y + m_window_pos.y, n, 1);
+    count -= n;
+    m_window_pos.x += n;
+    if (m_window_pos.x == m_window.width) {
+      m_window_pos.x = 0;
+      m_window_pos.y += 1;
+    }
+  }
+  set_pen_color(saved);
+}
+
 void
 Canvas::draw_string(char* s)
 {
@@ -545,3 +641,421 @@ Canvas::run(uint8_t ix, const void_P* tab, uint8_t max)
   }
 }
 
+int
+Canvas::compile(Script* script, uint8_t ix, const void_P* tab, uint8_t max)
+{
+  if (UNLIKELY(ix >= max)) return (EINVAL);
+
+  // Start with the current cursor, font and scale
+  uint16_t x, y;
+  get_cursor(x, y);
+  script->m_count = 0;
+  memset(&script->m_bbox, 0, sizeof(script->m_bbox));
+  script->m_x = x;
+  script->m_y = y;
+  script->m_font = get_text_font();
+  script->m_scale = get_text_scale();
+
+  // Start with the font and scale used for the text bounding boxes
+  Script::command_t* cp = script->append(SET_TEXT_FONT);
+  if (UNLIKELY(cp == NULL)) return (ENOMEM);
+  cp->ptr = script->m_font;
+  cp = script->append(SET_TEXT_SCALE);
+  if (UNLIKELY(cp == NULL)) return (ENOMEM);
+  cp->arg = script->m_scale;
+
+  const uint8_t* ip = (const uint8_t*) pgm_read_word(tab + ix);
+  int res = compile_P(script, ip, tab, max);
+
+  // Leave the cursor as after running the script
+  if (res == 0) {
+    cp = script->append(SET_CURSOR);
+    if (UNLIKELY(cp == NULL)) {
+      res = ENOMEM;
+    }
+    else {
+      cp->x = script->m_x;
+      cp->y = script->m_y;
+    }
+  }
+  if (UNLIKELY(res < 0)) {
+    script->m_count = 0;
+    return (res);
+  }
+  return (script->m_count);
+}
+
+int
+Canvas::compile_P(Script* script, const uint8_t* ip,
+		  const void_P* tab, uint8_t max)
+{
+  Script::command_t* cp;
+  const uint8_t* bp;
+  uint8_t ix, x, y, r, g, b, w, h, s, op;
+  int8_t dx, dy;
+  color16_t c;
+  uint16_t advance;
+  int res;
+  while (1) {
+    switch (op = pgm_read_byte(ip++)) {
+    case END_SCRIPT:
+      return (0);
+    case CALL_SCRIPT:
+      ix = pgm_read_byte(ip++);
+      if (UNLIKELY(ix >= max)) return (EINVAL);
+      bp = (const uint8_t*) pgm_read_word(tab + ix);
+      res = compile_P(script, bp, tab, max);
+      if (UNLIKELY(res < 0)) return (res);
+      break;
+    case SET_CANVAS_COLOR:
+    case SET_PEN_COLOR:
+    case SET_TEXT_COLOR:
+      r = pgm_read_byte(ip++);
+      g = pgm_read_byte(ip++);
+      b = pgm_read_byte(ip++);
+      c = (op == SET_CANVAS_COLOR) ? color(r, b, g) : color(r, g, b);
+      if ((cp = script->append(op)) == NULL) return (ENOMEM);
+      cp->rgb = c.rgb;
+      break;
+    case SET_TEXT_SCALE:
+      s = pgm_read_byte(ip++);
+      if ((cp = script->append(op)) == NULL) return (ENOMEM);
+      cp->arg = s;
+      script->m_scale = s;
+      break;
+    case SET_TEXT_FONT:
+      ix = pgm_read_byte(ip++);
+      if (UNLIKELY(ix >= max)) return (EINVAL);
+      if ((cp = script->append(op)) == NULL) return (ENOMEM);
+      script->m_font = (Font*) pgm_read_word(tab + ix);
+      cp->ptr = script->m_font;
+      break;
+    case SET_CURSOR:
+      script->m_x = pgm_read_byte(ip++);
+      script->m_y = pgm_read_byte(ip++);
+      break;
+    case MOVE_CURSOR:
+      dx = pgm_read_byte(ip++);
+      dy = pgm_read_byte(ip++);
+      script->m_x += dx;
+      script->m_y += dy;
+      break;
+    case DRAW_BITMAP:
+      ix = pgm_read_byte(ip++);
+      if (UNLIKELY(ix >= max)) return (EINVAL);
+      w = pgm_read_byte(ip++);
+      h = pgm_read_byte(ip++);
+      s = pgm_read_byte(ip++);
+      if ((cp = script->append(op)) == NULL) return (ENOMEM);
+      cp->x = script->m_x;
+      cp->y = script->m_y;
+      cp->w = w;
+      cp->h = h;
+      cp->arg = s;
+      cp->ptr = (const void*) pgm_read_word(tab + ix);
+      script->include(script->m_x, script->m_y, w * s, h * s);
+      break;
+    case DRAW_ICON:
+      ix = pgm_read_byte(ip++);
+      if (UNLIKELY(ix >= max)) return (EINVAL);
+      s = pgm_read_byte(ip++);
+      if ((cp = script->append(op)) == NULL) return (ENOMEM);
+      bp = (const uint8_t*) pgm_read_word(tab + ix);
+      cp->x = script->m_x;
+      cp->y = script->m_y;
+      cp->arg = s;
+      cp->ptr = bp;
+      w = pgm_read_byte(bp++);
+      h = pgm_read_byte(bp);
+      script->include(script->m_x, script->m_y, w * s, h * s);
+      break;
+    case DRAW_PIXEL:
+      if ((cp = script->append(op)) == NULL) return (ENOMEM);
+      cp->x = script->m_x;
+      cp->y = script->m_y;
+      script->include(script->m_x, script->m_y, 1, 1);
+      break;
+    case DRAW_LINE:
+      x = pgm_read_byte(ip++);
+      y = pgm_read_byte(ip++);
+      if (script->line(x, y) == NULL) return (ENOMEM);
+      break;
+    case DRAW_POLY:
+    case DRAW_STROKE:
+      ix = pgm_read_byte(ip++);
+      if (UNLIKELY(ix >= max)) return (EINVAL);
+      s = pgm_read_byte(ip++);
+      if (UNLIKELY(s == 0)) break;
+      bp = (const uint8_t*) pgm_read_word(tab + ix);
+      while (1) {
+	dx = pgm_read_byte(bp++);
+	dy = pgm_read_byte(bp++);
+	if (dx == 0 && dy == 0) break;
+	if ((op == DRAW_STROKE) && (dx <= 0 && dy <= 0)) {
+	  script->m_x += dx*s;
+	  script->m_y += dy*s;
+	}
+	else if (script->line(script->m_x + dx*s, script->m_y + dy*s) == NULL)
+	  return (ENOMEM);
+      }
+      break;
+    case DRAW_RECT:
+    case FILL_RECT:
+    case DRAW_ROUNDRECT:
+    case FILL_ROUNDRECT:
+      w = pgm_read_byte(ip++);
+      h = pgm_read_byte(ip++);
+      r = ((op == DRAW_ROUNDRECT) || (op == FILL_ROUNDRECT)) ?
+	pgm_read_byte(ip++) : 0;
+      if (op == FILL_RECT) {
+	if (script->rect(script->m_x, script->m_y, w, h) == NULL)
+	  return (ENOMEM);
+      }
+      else {
+	if ((cp = script->append(op)) == NULL) return (ENOMEM);
+	cp->x = script->m_x;
+	cp->y = script->m_y;
+	cp->w = w;
+	cp->h = h;
+	cp->arg = r;
+      }
+      script->include(script->m_x, script->m_y, w + 1, h + 1);
+      break;
+    case DRAW_CIRCLE:
+    case FILL_CIRCLE:
+      r = pgm_read_byte(ip++);
+      if ((cp = script->append(op)) == NULL) return (ENOMEM);
+      cp->x = script->m_x;
+      cp->y = script->m_y;
+      cp->arg = r;
+      script->include(script->m_x - r, script->m_y - r, 2*r + 1, 2*r + 1);
+      break;
+    case DRAW_CHAR:
+    case DRAW_STRING:
+      ix = pgm_read_byte(ip++);
+      if ((cp = script->append(op)) == NULL) return (ENOMEM);
+      cp->x = script->m_x;
+      cp->y = script->m_y;
+      if (op == DRAW_CHAR) {
+	cp->arg = ix;
+	w = 1;
+      }
+      else {
+	if (UNLIKELY(ix >= max)) return (EINVAL);
+	cp->ptr = (const void*) pgm_read_word(tab + ix);
+	w = strlen_P((const char*) cp->ptr);
+      }
+      s = script->m_scale;
+      advance = s * (script->m_font->WIDTH + script->m_font->SPACING);
+      script->include(script->m_x, script->m_y,
+		      w * advance, s * script->m_font->HEIGHT);
+      script->m_x += w * advance;
+      break;
+    case FILL_SCREEN:
+      if ((cp = script->append(op)) == NULL) return (ENOMEM);
+      script->include(0, 0, WIDTH, HEIGHT);
+      break;
+    default:
+      return (EINVAL);
+    }
+  }
+}
+
+void
+Canvas::run(const Script* script)
+{
+  const Script::command_t* cp = script->m_command;
+  for (uint8_t i = 0; i < script->m_count; i++, cp++) execute(cp);
+}
+
+void
+Canvas::run(const rect16_t& dirty, Script* const* scripts, uint8_t count)
+{
+  for (uint8_t i = 0; i < count; i++) {
+    const Script* script = scripts[i];
+    if ((script->m_bbox.width == 0) || script->intersects(dirty)) {
+      run(script);
+      continue;
+    }
+
+    // Skip drawing but keep the state settings (colors, text font and
+    // scale, and cursor) for the following scripts
+    const Script::command_t* cp = script->m_command;
+    for (uint8_t j = 0; j < script->m_count; j++, cp++)
+      if (cp->op < DRAW_BITMAP) execute(cp);
+  }
+}
+
+void
+Canvas::execute(const Script::command_t* cp)
+{
+  switch (cp->op) {
+  case SET_CANVAS_COLOR:
+    set_canvas_color(cp->rgb);
+    break;
+  case SET_PEN_COLOR:
+    set_pen_color(cp->rgb);
+    break;
+  case SET_TEXT_COLOR:
+    set_text_color(cp->rgb);
+    break;
+  case SET_TEXT_SCALE:
+    set_text_scale(cp->arg);
+    break;
+  case SET_TEXT_FONT:
+    set_text_font((Font*) cp->ptr);
+    break;
+  case SET_CURSOR:
+    set_cursor(cp->x, cp->y);
+    break;
+  case DRAW_BITMAP:
+    draw_bitmap(cp->x, cp->y, (const uint8_t*) cp->ptr, cp->w, cp->h, cp->arg);
+    break;
+  case DRAW_ICON:
+    draw_icon(cp->x, cp->y, (const uint8_t*) cp->ptr, cp->arg);
+    break;
+  case DRAW_PIXEL:
+    draw_pixel(cp->x, cp->y);
+    break;
+  case DRAW_LINE:
+    draw_line(cp->x, cp->y, cp->w, cp->h);
+    break;
+  case DRAW_RECT:
+    draw_rect(cp->x, cp->y, cp->w, cp->h);
+    break;
+  case FILL_RECT:
+    fill_rect(cp->x, cp->y, cp->w, cp->h);
+    break;
+  case DRAW_ROUNDRECT:
+    draw_roundrect(cp->x, cp->y, cp->w, cp->h, cp->arg);
+    break;
+  case FILL_ROUNDRECT:
+    fill_roundrect(cp->x, cp->y, cp->w, cp->h, cp->arg);
+    break;
+  case DRAW_CIRCLE:
+    draw_circle(cp->x, cp->y, cp->arg);
+    break;
+  case FILL_CIRCLE:
+    fill_circle(cp->x, cp->y, cp->arg);
+    break;
+  case DRAW_CHAR:
+    draw_char(cp->x, cp->y, cp->arg);
+    break;
+  case DRAW_STRING:
+    set_cursor(cp->x, cp->y);
+    draw_string((str_P) cp->ptr);
+    break;
+  case FILL_SCREEN:
+    fill_screen();
+    break;
+  }
+}
+
+bool
+Canvas::Script::intersects(const rect16_t& rect) const
+{
+  if (UNLIKELY((m_bbox.width == 0) || (rect.width == 0))) return (false);
+  return ((m_bbox.x < rect.x + rect.width)
+	  && (rect.x < m_bbox.x + m_bbox.width)
+	  && (m_bbox.y < rect.y + rect.height)
+	  && (rect.y < m_bbox.y + m_bbox.height));
+}
+
+Canvas::Script::command_t*
+Canvas::Script::append(uint8_t op)
+{
+  // Merge with directly preceding setting of the same state
+  if ((op < DRAW_BITMAP) && (m_count != 0)
+      && (m_command[m_count - 1].op == op))
+    return (&m_command[m_count - 1]);
+  if (UNLIKELY(m_count == m_max)) return (NULL);
+  command_t* cp = &m_command[m_count++];
+  memset(cp, 0, sizeof(command_t));
+  cp->op = op;
+  return (cp);
+}
+
+void
+Canvas::Script::include(int16_t x, int16_t y, uint16_t width, uint16_t height)
+{
+  int32_t x1 = (int32_t) x + width;
+  int32_t y1 = (int32_t) y + height;
+  if (x < 0) x = 0;
+  if (y < 0) y = 0;
+  if ((x1 <= x) || (y1 <= y)) return;
+  if (m_bbox.width == 0) {
+    m_bbox.x = x;
+    m_bbox.y = y;
+    m_bbox.width = x1 - x;
+    m_bbox.height = y1 - y;
+    return;
+  }
+  if (x1 < m_bbox.x + m_bbox.width) x1 = m_bbox.x + m_bbox.width;
+  if (y1 < m_bbox.y + m_bbox.height) y1 = m_bbox.y + m_bbox.height;
+  if (x < m_bbox.x) m_bbox.x = x;
+  if (y < m_bbox.y) m_bbox.y = y;
+  m_bbox.width = x1 - m_bbox.x;
+  m_bbox.height = y1 - m_bbox.y;
+}
+
+Canvas::Script::command_t*
+Canvas::Script::rect(int16_t x, int16_t y, uint16_t w, uint16_t h)
+{
+  // Extend a directly preceding span with the same column or row when
+  // the union is a rectangle (the spans touch or overlap)
+  if ((m_count != 0) && (w != 0) && (h != 0)) {
+    command_t* cp = &m_command[m_count - 1];
+    if ((cp->op == FILL_RECT) && (cp->w != 0) && (cp->h != 0)) {
+      int16_t cx = cp->x;
+      int16_t cy = cp->y;
+      int32_t cx1 = (int32_t) cx + cp->w;
+      int32_t cy1 = (int32_t) cy + cp->h;
+      int32_t x1 = (int32_t) x + w;
+      int32_t y1 = (int32_t) y + h;
+      if ((cx == x) && (cp->w == w) && (y <= cy1) && (cy <= y1)) {
+	if (y < cy) cp->y = y;
+	cp->h = ((y1 > cy1) ? y1 : cy1) - (int16_t) cp->y;
+	return (cp);
+      }
+      if ((cy == y) && (cp->h == h) && (x <= cx1) && (cx <= x1)) {
+	if (x < cx) cp->x = x;
+	cp->w = ((x1 > cx1) ? x1 : cx1) - (int16_t) cp->x;
+	return (cp);
+      }
+    }
+  }
+  command_t* cp = append(FILL_RECT);
+  if (UNLIKELY(cp == NULL)) return (NULL);
+  cp->x = x;
+  cp->y = y;
+  cp->w = w;
+  cp->h = h;
+  return (cp);
+}
+
+Canvas::Script::command_t*
+Canvas::Script::line(int16_t x, int16_t y)
+{
+  int16_t x0 = (x < m_x) ? x : m_x;
+  int16_t y0 = (y < m_y) ? y : m_y;
+  uint16_t w = ((x < m_x) ? m_x - x : x - m_x) + 1;
+  uint16_t h = ((y < m_y) ? m_y - y : y - m_y) + 1;
+  command_t* cp;
+  if (w == 1 || h == 1) {
+    cp = rect(x0, y0, w, h);
+    if (UNLIKELY(cp == NULL)) return (NULL);
+  }
+  else {
+    cp = append(DRAW_LINE);
+    if (UNLIKELY(cp == NULL)) return (NULL);
+    cp->x = m_x;
+    cp->y = m_y;
+    cp->w = x;
+    cp->h = y;
+  }
+  include(x0, y0, w, h);
+  m_x = x;
+  m_y = y;
+  return (cp);
+}
+
@@ -108,6 +108,15 @@ public:
     MAGENTA = RED + BLUE
   };
 
+  /**
+   * Text drawing mode; transparent (text color only) or opaque (text
+   * color on canvas color background).
+   */
+  enum {
+    TRANSPARENT_TEXT_MODE = 0,
+    OPAQUE_TEXT_MODE = 1
+  } __attribute__((packed));
+
   /**
    * Canvas position<x,y>.
    */
@@ -143,7 +152,7 @@ public:
     /**
      * Construct a drawing context with default pen color(BLACK),
      * canvas color(WHITE), text color(BLACK), text scale(1),
-     * and cursor at (0, 0).
+     * transparent text mode and cursor at (0, 0).
      * @param[in] font default is the system font.
      * @pre font != 0
      */
@@ -152,6 +161,7 @@ public:
       m_canvas_color(WHITE),
       m_text_color(BLACK),
       m_text_scale(1),
+      m_text_mode(TRANSPARENT_TEXT_MODE),
       m_font(font)
     {
       set_cursor(0, 0);
@@ -263,6 +273,28 @@ public:
       return (previous);
     }
 
+    /**
+     * Get context text mode.
+     * @return text mode.
+     */
+    uint8_t get_text_mode() const
+    {
+      return (m_text_mode);
+    }
+
+    /**
+     * Set context text mode (TRANSPARENT_TEXT_MODE or
+     * OPAQUE_TEXT_MODE). Return previous text mode.
+     * @param[in] mode.
+     * @return previous mode.
+     */
+    uint8_t set_text_mode(uint8_t mode)
+    {
+      uint8_t previous = m_text_mode;
+      m_text_mode = mode;
+      return (previous);
+    }
+
     /**
      * Get context cursor position.
      * @param[out] x.
@@ -301,6 +333,7 @@ public:
     color16_t m_canvas_color;	//!< Current background color.
     color16_t m_text_color;	//!< Current text color.
     uint8_t m_text_scale;	//!< Current text scale.
+    uint8_t m_text_mode;	//!< Current text mode.
     Font* m_font;		//!< Current font.
     pos16_t m_cursor;		//!< Current cursor position.
   };
@@ -509,6 +542,26 @@ public:
     return (m_context->set_text_scale(scale));
   }
 
+  /**
+   * Get current text mode.
+   * @return text mode.
+   */
+  uint8_t get_text_mode() const
+  {
+    return (m_context->get_text_mode());
+  }
+
+  /**
+   * Set current text mode (TRANSPARENT_TEXT_MODE or
+   * OPAQUE_TEXT_MODE). Return previous text mode.
+   * @param[in] mode.
+   * @return previous mode.
+   */
+  uint8_t set_text_mode(uint8_t mode)
+  {
+    return (m_context->set_text_mode(mode));
+  }
+
   /**
    * Get current cursor position.
    * @param[out] x.
@@ -603,7 +656,8 @@ public:
   /**
    * @override{Canvas}
    * Draw bitmap with current pen color. The bitmap must be stored
-   * in program memory.
+   * in program memory. The bitmap is drawn as glyph strips; in
+   * opaque text mode the clear bits are drawn with the canvas color.
    * @param[in] x.
    * @param[in] y.
    * @param[in] bp.
@@ -676,7 +730,8 @@ public:
 
   /**
    * @override{Canvas}
-   * Draw image on canvas at given position.
+   * Draw image on canvas at given position. The image pixels are
+   * written to an address window.
    * @param[in] x.
    * @param[in] y.
    * @param[in] image.
@@ -697,7 +752,8 @@ public:
 
   /**
    * @override{Canvas}
-   * Draw line with current pen color.
+   * Draw line with current pen color. The line is drawn as horizontal
+   * or vertical runs with fill_rect().
    * @param[in] x0.
    * @param[in] y0.
    * @param[in] x1.
@@ -879,7 +935,8 @@ public:
 
   /**
    * @override{Canvas}
-   * Draw circle with current pen color.
+   * Draw circle with current pen color. The circle is drawn as
+   * horizontal and vertical octant spans with fill_rect().
    * @param[in] x.
    * @param[in] y.
    * @param[in] radius.
@@ -937,6 +994,65 @@ public:
     draw_char(x, y, c);
   }
 
+  /**
+   * @override{Canvas}
+   * Draw glyph strip with current pen color and given scale. The
+   * strip is given as column bytes (in memory) with the least
+   * significant bit as the top row; max 8 rows. In opaque text mode
+   * the clear bits are drawn with the canvas color. The default
+   * implementation fills vertical spans of set bits. Should be
+   * overridden by devices that may stream the strip to an address
+   * window.
+   * @param[in] x position.
+   * @param[in] y position.
+   * @param[in] bp column bytes.
+   * @param[in] width number of columns.
+   * @param[in] height number of rows (1..8).
+   * @param[in] scale.
+   */
+  virtual void draw_glyph(uint16_t x, uint16_t y, const uint8_t* bp,
+			  uint8_t width, uint8_t height,
+			  uint8_t scale = 1);
+
+  /**
+   * @override{Canvas}
+   * Begin write of pixels to the given address window. The pixels are
+   * written with window_write() and window_fill() in scanning order;
+   * left to right, top to bottom. The default implementation tracks
+   * the position in the window and fills the pixel runs with
+   * fill_rect(). Should be overridden by devices with address window
+   * and streaming of pixels.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] width.
+   * @param[in] height.
+   */
+  virtual void window_begin(uint16_t x, uint16_t y,
+			    uint16_t width, uint16_t height);
+
+  /**
+   * @override{Canvas}
+   * Write the given pixels to the address window.
+   * @param[in] buf pixel buffer.
+   * @param[in] count number of pixels.
+   */
+  virtual void window_write(const color16_t* buf, size_t count);
+
+  /**
+   * @override{Canvas}
+   * Write the given number of pixels with the given color to the
+   * address window.
+   * @param[in] color.
+   * @param[in] count number of pixels.
+   */
+  virtual void window_fill(color16_t color, uint16_t count);
+
+  /**
+   * @override{Canvas}
+   * End write of pixels to address window.
+   */
+  virtual void window_end() {}
+
   /**
    * @override{Canvas}
    * Draw string in current text color, font and scale.
@@ -1004,7 +1120,185 @@ public:
    */
   void run(uint8_t ix, const void_P* tab, uint8_t max);
 
+  /**
+   * Pre-decoded canvas script. A script is compiled once to a list of
+   * commands with resolved table references, absolute positions and
+   * decoded colors. Sub-scripts are inlined and cursor movement is
+   * folded into the drawing commands. Consecutive settings of the same
+   * state are merged. Horizontal and vertical lines, also the segments
+   * of polygons and strokes, are reduced to rectangle spans, and
+   * adjacent spans and filled rectangles in the same row or column are
+   * merged. Diagonal lines are not merged. The bounding box of the
+   * drawing commands is recorded so that a script may be skipped when
+   * it does not intersect a dirty region.
+   */
+  class Script {
+  public:
+    /** Pre-decoded command. */
+    struct command_t {
+      uint8_t op;		//!< Script instruction.
+      uint8_t arg;		//!< Scale, radius or character.
+      uint16_t x;		//!< Position x.
+      uint16_t y;		//!< Position y.
+      uint16_t w;		//!< Width (or line end x).
+      uint16_t h;		//!< Height (or line end y).
+      union {
+	uint16_t rgb;		//!< Color.
+	const void* ptr;	//!< Table reference.
+      };
+    };
+
+    /**
+     * Construct script with given command buffer and max number of
+     * commands.
+     * @param[in] buf command buffer.
+     * @param[in] max number of commands in buffer.
+     */
+    Script(command_t* buf, uint8_t max) :
+      m_command(buf),
+      m_max(max),
+      m_count(0)
+    {
+      memset(&m_bbox, 0, sizeof(m_bbox));
+    }
+
+    /**
+     * Return number of commands.
+     * @return count.
+     */
+    uint8_t count() const
+    {
+      return (m_count);
+    }
+
+    /**
+     * Get the bounding box of the script drawing commands. The width
+     * is zero if the script does not draw.
+     * @param[out] rect bounding box.
+     */
+    void get_bbox(rect16_t& rect) const
+    {
+      rect = m_bbox;
+    }
+
+    /**
+     * Return true(1) if the bounding box of the script intersects the
+     * given region otherwise false(0).
+     * @param[in] rect region.
+     * @return bool.
+     */
+    bool intersects(const rect16_t& rect) const;
+
+  protected:
+    friend class Canvas;
+    command_t* m_command;	//!< Command buffer.
+    uint8_t m_max;		//!< Max number of commands.
+    uint8_t m_count;		//!< Number of commands.
+    rect16_t m_bbox;		//!< Bounding box.
+    int16_t m_x;		//!< Cursor x during compile.
+    int16_t m_y;		//!< Cursor y during compile.
+    Font* m_font;		//!< Text font during compile.
+    uint8_t m_scale;		//!< Text scale during compile.
+
+    /**
+     * Append command with given instruction and return pointer to the
+     * command, or NULL if the buffer is full. A state setting replaces
+     * a directly preceding setting of the same state.
+     * @param[in] op script instruction.
+     * @return command or NULL.
+     */
+    command_t* append(uint8_t op);
+
+    /**
+     * Add given region to the bounding box. Negative positions are
+     * clipped.
+     * @param[in] x.
+     * @param[in] y.
+     * @param[in] width.
+     * @param[in] height.
+     */
+    void include(int16_t x, int16_t y, uint16_t width, uint16_t height);
+
+    /**
+     * Append filled rectangle with given position and size, and return
+     * pointer to the command, or NULL if the buffer is full. A
+     * directly preceding filled rectangle with the same column (x and
+     * width) or row (y and height) is extended instead when the two
+     * touch or overlap.
+     * @param[in] x.
+     * @param[in] y.
+     * @param[in] w width.
+     * @param[in] h height.
+     * @return command or NULL.
+     */
+    command_t* rect(int16_t x, int16_t y, uint16_t w, uint16_t h);
+
+    /**
+     * Append line from the cursor to the given position and move the
+     * cursor. Horizontal and vertical lines are appended as rectangle
+     * spans and merged with adjacent spans (see rect()). Returns
+     * pointer to the command or NULL if the buffer is full.
+     * @param[in] x.
+     * @param[in] y.
+     * @return command or NULL.
+     */
+    command_t* line(int16_t x, int16_t y);
+  };
+
+  /**
+   * Compile canvas script to the given pre-decoded script. The
+   * compile starts with the current cursor, text font and text scale.
+   * The script begins with setting the text font and scale, used for
+   * the text bounding boxes, and ends with setting the cursor.
+   * Returns number of commands or negative error code; EINVAL(-22) if
+   * the script has an illegal instruction or table index, ENOMEM(-12)
+   * if the command buffer is too small.
+   * @param[in] script pre-decoded script.
+   * @param[in] ix script to compile.
+   * @param[in] tab script table in program memory.
+   * @param[in] max size of script table.
+   * @return number of commands or negative error code.
+   */
+  int compile(Script* script, uint8_t ix, const void_P* tab, uint8_t max);
+
+  /**
+   * Run pre-decoded script.
+   * @param[in] script pre-decoded script.
+   */
+  void run(const Script* script);
+
+  /**
+   * Run the pre-decoded scripts in the given list that intersect the
+   * given dirty region. Scripts with an empty bounding box (only
+   * state settings) are always run. Only the state settings of the
+   * other scripts are performed so that the following scripts are
+   * run with the same state as when running all scripts.
+   * @param[in] dirty region.
+   * @param[in] scripts list of pre-decoded scripts.
+   * @param[in] count number of scripts in list.
+   */
+  void run(const rect16_t& dirty, Script* const* scripts, uint8_t count);
+
 protected:
+  /**
+   * Compile canvas script instructions at given program memory
+   * pointer to the given pre-decoded script. Sub-scripts are compiled
+   * recursively. Returns zero or negative error code.
+   * @param[in] script pre-decoded script.
+   * @param[in] ip script instruction pointer in program memory.
+   * @param[in] tab script table in program memory.
+   * @param[in] max size of script table.
+   * @return zero or negative error code.
+   */
+  int compile_P(Script* script, const uint8_t* ip,
+		const void_P* tab, uint8_t max);
+
+  /**
+   * Perform given pre-decoded script command.
+   * @param[in] cp command.
+   */
+  void execute(const Script::command_t* cp);
+
   /** Default Canvas context (Factory pattern). */
   static Context context;
 
@@ -1013,6 +1307,25 @@ protected:
 
   /** Canvas direction (LANDSCAPE/PORTRAIT). */
   uint8_t m_direction;
+
+  /**
+   * Fill the eight octant spans of a circle with given center for
+   * the given run of offsets (first..last) at the given distance.
+   * @param[in] x center.
+   * @param[in] y center.
+   * @param[in] first offset of run.
+   * @param[in] last offset of run.
+   * @param[in] r distance.
+   */
+  void draw_circle_spans(uint16_t x, uint16_t y,
+			 uint16_t first, uint16_t last,
+			 uint16_t r);
+
+  /** Address window (default window implementation). */
+  rect16_t m_window;
+
+  /** Position in address window (default window implementation). */
+  pos16_t m_window_pos;
 };
 
 /**
@@ -0,0 +1,299 @@
+/**
+ * @file Canvas/FrameBuffer.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_CANVAS_FRAMEBUFFER_HH
+#define COSA_CANVAS_FRAMEBUFFER_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/IOStream.hh"
+
+/**
+ * Frame buffer canvas with RGB<5,6,5> pixels in memory. The canvas
+ * implements the same primitives as the GDDRAM device driver and
+ * counts the driver operations; address windows, pixels pushed and
+ * the number of bytes that would be transferred on the SPI bus. Used
+ * to compare rendering paths and verify the output (as a PPM image)
+ * without display hardware. The buffer requires 2 * width * height
+ * bytes; a host build or a board with sufficient memory.
+ * @param[in] width of canvas.
+ * @param[in] height of canvas.
+ */
+template<uint16_t width, uint16_t height>
+class FrameBuffer : public Canvas {
+public:
+  /** Driver operation counters. */
+  struct stats_t {
+    uint32_t windows;		//!< Number of address windows set.
+    uint32_t pixels;		//!< Number of pixels pushed.
+    uint32_t bytes;		//!< Number of bytes on the bus.
+  };
+
+  /** Bytes per address window; CASET(1+4), PASET(1+4) and RAMWR(1). */
+  static const uint8_t WINDOW_BYTES = 11;
+
+  /**
+   * Construct frame buffer canvas with given width and height.
+   */
+  FrameBuffer() : Canvas(width, height)
+  {
+    reset();
+  }
+
+  /**
+   * Return driver operation counters.
+   * @return counters.
+   */
+  const stats_t& stats() const
+  {
+    return (m_stats);
+  }
+
+  /**
+   * Reset driver operation counters.
+   */
+  void reset()
+  {
+    memset(&m_stats, 0, sizeof(m_stats));
+  }
+
+  /**
+   * Return color of pixel at given position.
+   * @param[in] x.
+   * @param[in] y.
+   * @return color.
+   */
+  color16_t get_pixel(uint16_t x, uint16_t y) const
+  {
+    return (m_buffer[(y * width) + x]);
+  }
+
+  /**
+   * Write frame buffer as a binary PPM (P6) image to the given
+   * output stream.
+   * @param[in] outs output stream.
+   */
+  void dump(IOStream& outs)
+  {
+    IOStream::Device* dev = outs.device();
+    if (UNLIKELY(dev == NULL)) return;
+    outs << PSTR("P6") << endl
+	 << width << ' ' << height << endl
+	 << 255 << endl;
+    for (uint16_t i = 0; i < width * height; i++) {
+      color16_t color = m_buffer[i];
+      dev->putchar((color.red << 3) | (color.red >> 2));
+      dev->putchar((color.green << 2) | (color.green >> 4));
+      dev->putchar((color.blue << 3) | (color.blue >> 2));
+    }
+  }
+
+  /**
+   * @override{Canvas}
+   * Start interaction with frame buffer.
+   * @return true(1) if successful otherwise false(0).
+   */
+  virtual bool begin()
+  {
+    return (true);
+  }
+
+  /**
+   * @override{Canvas}
+   * Set pixel with current pen color.
+   * @param[in] x.
+   * @param[in] y.
+   */
+  virtual void draw_pixel(uint16_t x, uint16_t y)
+  {
+    window(x, y, 1, 1);
+    push(get_pen_color(), 1);
+  }
+
+  /**
+   * @override{Canvas}
+   * Draw vertical line with given length and current pen color.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] length.
+   */
+  virtual void draw_vertical_line(uint16_t x, uint16_t y, uint16_t length)
+  {
+    fill_rect(x, y, 1, length);
+  }
+
+  /**
+   * @override{Canvas}
+   * Draw horizontal line with given length and current pen color.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] length.
+   */
+  virtual void draw_horizontal_line(uint16_t x, uint16_t y, uint16_t length)
+  {
+    fill_rect(x, y, length, 1);
+  }
+
+  /**
+   * @override{Canvas}
+   * Fill rectangle with current pen color.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] w width.
+   * @param[in] h height.
+   */
+  virtual void fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+  {
+    if (UNLIKELY((x >= width) || (y >= height))) return;
+    if (w > width - x) w = width - x;
+    if (h > height - y) h = height - y;
+    if (UNLIKELY((w == 0) || (h == 0))) return;
+    window(x, y, w, h);
+    push(get_pen_color(), (uint32_t) w * h);
+  }
+
+  /**
+   * @override{Canvas}
+   * Draw glyph strip. Opaque strips are written as a single address
+   * window as the GDDRAM device driver.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] bp glyph strip.
+   * @param[in] w width (columns).
+   * @param[in] h height (rows).
+   * @param[in] scale.
+   */
+  virtual void draw_glyph(uint16_t x, uint16_t y, const uint8_t* bp,
+			  uint8_t w, uint8_t h,
+			  uint8_t scale = 1)
+  {
+    if ((get_text_mode() != OPAQUE_TEXT_MODE)
+	|| ((x + w * scale) > width) || ((y + h * scale) > height)) {
+      Canvas::draw_glyph(x, y, bp, w, h, scale);
+      return;
+    }
+    if (UNLIKELY((w == 0) || (h == 0) || (scale == 0))) return;
+    const color16_t fg = get_pen_color();
+    const color16_t bg = get_canvas_color();
+    window(x, y, w * scale, h * scale);
+    for (uint8_t mask = 1; h != 0; h--, mask <<= 1) {
+      for (uint8_t s = 0; s < scale; s++) {
+	for (uint8_t j = 0; j < w; j++)
+	  push((bp[j] & mask) ? fg : bg, scale);
+      }
+    }
+  }
+
+  /**
+   * @override{Canvas}
+   * Set address window.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] w width.
+   * @param[in] h height.
+   */
+  virtual void window_begin(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+  {
+    window(x, y, w, h);
+  }
+
+  /**
+   * @override{Canvas}
+   * Write given pixels to address window.
+   * @param[in] buf pixel buffer.
+   * @param[in] count number of pixels.
+   */
+  virtual void window_write(const color16_t* buf, size_t count)
+  {
+    while (count--) push(*buf++, 1);
+  }
+
+  /**
+   * @override{Canvas}
+   * Write given number of pixels with given color to address window.
+   * @param[in] color.
+   * @param[in] count number of pixels.
+   */
+  virtual void window_fill(color16_t color, uint16_t count)
+  {
+    push(color, count);
+  }
+
+  /**
+   * @override{Canvas}
+   * Stop sequence of interaction with frame buffer.
+   * @return true(1) if successful otherwise false(0).
+   */
+  virtual bool end()
+  {
+    return (true);
+  }
+
+protected:
+  /** Frame buffer. */
+  color16_t m_buffer[width * height];
+
+  /** Driver operation counters. */
+  stats_t m_stats;
+
+  /**
+   * Set address window and reset write position.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] w width.
+   * @param[in] h height.
+   */
+  void window(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+  {
+    m_window.x = x;
+    m_window.y = y;
+    m_window.width = w;
+    m_window.height = h;
+    m_window_pos.x = 0;
+    m_window_pos.y = 0;
+    m_stats.windows += 1;
+    m_stats.bytes += WINDOW_BYTES;
+  }
+
+  /**
+   * Write given number of pixels with given color at the address
+   * window write position. Pixels outside the window or frame
+   * buffer are counted but not stored.
+   * @param[in] color.
+   * @param[in] count number of pixels.
+   */
+  void push(color16_t color, uint32_t count)
+  {
+    m_stats.pixels += count;
+    m_stats.bytes += count * 2;
+    while ((count != 0) && (m_window_pos.y < m_window.height)) {
+      uint16_t x = m_window.x + m_window_pos.x;
+      uint16_t y = m_window.y + m_window_pos.y;
+      if ((x < width) && (y < height)) m_buffer[(y * width) + x] = color;
+      count -= 1;
+      m_window_pos.x += 1;
+      if (m_window_pos.x == m_window.width) {
+	m_window_pos.x = 0;
+	m_window_pos.y += 1;
+      }
+    }
+  }
+};
+
+#endif
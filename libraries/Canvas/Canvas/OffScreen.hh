@@ -25,18 +25,29 @@
 
 /**
  * Off-screen canvas for drawing before copying to the canvas device.
- * Supports monochrome, 1-bit, pixel in off-screen buffer. Minimum
- * implementation; draw_pixel() only.
+ * Supports monochrome (1-bit), RGB<3,3,2> (8-bit) and RGB<5,6,5>
+ * (16-bit) pixels in off-screen buffer. The monochrome buffer is
+ * stored in pages (8 rows per byte) as the bitmap of page addressed
+ * LCD devices. The region that has been drawn since the latest flush
+ * is tracked as a dirty rectangle; flush_to() and flush_pages() copy
+ * only this region to the device.
  * @param[in] width of canvas.
  * @param[in] height of canvas.
+ * @param[in] depth bits per pixel; 1, 8 or 16 (Default 1).
  */
-template<uint16_t width, uint16_t height>
+template<uint16_t width, uint16_t height, uint8_t depth = 1>
 class OffScreen : public Canvas {
 public:
+  /** Color depth; bits per pixel. */
+  static const uint8_t DEPTH = depth;
+
   /**
    * Construct off-screen canvas with given width and height.
    */
-  OffScreen() : Canvas(width, height) {}
+  OffScreen() : Canvas(width, height)
+  {
+    mark_clean();
+  }
 
   /**
    * Get bitmap for the off-screen canvas.
@@ -66,13 +77,29 @@ public:
    */
   virtual void draw_pixel(uint16_t x, uint16_t y)
   {
-    if (UNLIKELY((x > WIDTH) || (y > HEIGHT))) return;
-    uint8_t* bp = &m_bitmap[((y >> 3) * WIDTH) + x];
-    uint8_t pos = (y & 0x07);
-    if (get_pen_color().rgb == Canvas::BLACK)
-      *bp |= (1 << pos);
-    else
-      *bp &= ~(1 << pos);
+    if (UNLIKELY((x >= width) || (y >= height))) return;
+    set_pixel(x, y, get_pen_color());
+    mark_dirty(x, y, 1, 1);
+  }
+
+  /**
+   * @override{Canvas}
+   * Fill rectangle with current pen color.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] w width.
+   * @param[in] h height.
+   */
+  virtual void fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+  {
+    if (UNLIKELY((x >= width) || (y >= height))) return;
+    if (w > width - x) w = width - x;
+    if (h > height - y) h = height - y;
+    const color16_t color = get_pen_color();
+    for (uint16_t i = 0; i < h; i++)
+      for (uint16_t j = 0; j < w; j++)
+	set_pixel(x + j, y + i, color);
+    mark_dirty(x, y, w, h);
   }
 
   /**
@@ -81,7 +108,18 @@ public:
    */
   virtual void fill_screen()
   {
-    memset(m_bitmap, (get_canvas_color().rgb == Canvas::BLACK), COUNT);
+    const color16_t color = get_canvas_color();
+    if (DEPTH == 1) {
+      memset(m_bitmap, (color.rgb == Canvas::BLACK) ? 0xff : 0x00, COUNT);
+    }
+    else if (DEPTH == 8) {
+      memset(m_bitmap, rgb332(color), COUNT);
+    }
+    else {
+      uint16_t* dp = (uint16_t*) m_bitmap;
+      for (uint16_t i = 0; i < COUNT / 2; i++) *dp++ = color.rgb;
+    }
+    mark_dirty(0, 0, width, height);
   }
 
   /**
@@ -94,9 +132,201 @@ public:
     return (true);
   }
 
+  /**
+   * Return color of pixel at given position. Monochrome pixels are
+   * returned as BLACK(set) or WHITE.
+   * @param[in] x.
+   * @param[in] y.
+   * @return color.
+   */
+  color16_t get_pixel(uint16_t x, uint16_t y) const
+  {
+    if (DEPTH == 1) {
+      uint8_t bits = m_bitmap[((y >> 3) * width) + x];
+      return ((bits & _BV(y & 0x07)) ? Canvas::BLACK : Canvas::WHITE);
+    }
+    if (DEPTH == 8) {
+      uint8_t rgb = m_bitmap[(y * width) + x];
+      color16_t color;
+      color.red = ((rgb >> 3) & 0x1c) | ((rgb >> 6) & 0x03);
+      color.green = ((rgb << 1) & 0x38) | ((rgb >> 2) & 0x07);
+      color.blue = ((rgb << 3) & 0x18) | ((rgb << 1) & 0x06) | ((rgb >> 1) & 0x01);
+      return (color);
+    }
+    return (((const uint16_t*) m_bitmap)[(y * width) + x]);
+  }
+
+  /**
+   * Return true(1) if the off-screen canvas has been drawn since the
+   * latest flush otherwise false(0).
+   * @return bool.
+   */
+  bool is_dirty() const
+  {
+    return (m_dirty.width != 0);
+  }
+
+  /**
+   * Get the dirty rectangle; the region drawn since the latest flush.
+   * The width is zero if nothing has been drawn.
+   * @param[out] rect dirty rectangle.
+   */
+  void get_dirty(rect16_t& rect) const
+  {
+    rect = m_dirty;
+  }
+
+  /**
+   * Add given region to the dirty rectangle. The region should be
+   * within the off-screen canvas.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] w width.
+   * @param[in] h height.
+   */
+  void mark_dirty(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+  {
+    if (UNLIKELY((w == 0) || (h == 0))) return;
+    if (m_dirty.width == 0) {
+      m_dirty.x = x;
+      m_dirty.y = y;
+      m_dirty.width = w;
+      m_dirty.height = h;
+      return;
+    }
+    uint16_t x1 = m_dirty.x + m_dirty.width;
+    uint16_t y1 = m_dirty.y + m_dirty.height;
+    if (x + w > x1) x1 = x + w;
+    if (y + h > y1) y1 = y + h;
+    if (x < m_dirty.x) m_dirty.x = x;
+    if (y < m_dirty.y) m_dirty.y = y;
+    m_dirty.width = x1 - m_dirty.x;
+    m_dirty.height = y1 - m_dirty.y;
+  }
+
+  /**
+   * Mark the off-screen canvas as flushed.
+   */
+  void mark_clean()
+  {
+    m_dirty.x = 0;
+    m_dirty.y = 0;
+    m_dirty.width = 0;
+    m_dirty.height = 0;
+  }
+
+  /**
+   * Copy the dirty rectangle to the given canvas at the given offset
+   * and mark as flushed. Monochrome pixels are drawn with the canvas
+   * pen color (set) and canvas color as glyph strips; one address
+   * window per 8 rows on devices that support this. Color pixels are
+   * streamed to an address window.
+   * @param[in] canvas to copy to.
+   * @param[in] x offset on canvas (Default 0).
+   * @param[in] y offset on canvas (Default 0).
+   */
+  void flush_to(Canvas* canvas, uint16_t x = 0, uint16_t y = 0)
+  {
+    if (!is_dirty()) return;
+    const rect16_t r = m_dirty;
+    if (DEPTH == 1) {
+      uint8_t mode = canvas->set_text_mode(OPAQUE_TEXT_MODE);
+      uint16_t last = (r.y + r.height - 1) >> 3;
+      for (uint16_t line = (r.y >> 3); line <= last; line++) {
+	uint16_t top = line << 3;
+	uint8_t rows = (height - top < CHARBITS) ? height - top : CHARBITS;
+	const uint8_t* bp = &m_bitmap[(line * width) + r.x];
+	uint8_t n;
+	for (uint16_t j = 0; j < r.width; j += n) {
+	  n = (r.width - j > 255) ? 255 : r.width - j;
+	  canvas->draw_glyph(x + r.x + j, y + top, bp + j, n, rows);
+	}
+      }
+      canvas->set_text_mode(mode);
+    }
+    else {
+      canvas->window_begin(x + r.x, y + r.y, r.width, r.height);
+      for (uint16_t i = r.y; i < r.y + r.height; i++) {
+	color16_t buf[Image::BUFFER_MAX];
+	uint8_t count;
+	for (uint16_t j = 0; j < r.width; j += count) {
+	  count = (r.width - j > Image::BUFFER_MAX) ? Image::BUFFER_MAX : r.width - j;
+	  for (uint8_t k = 0; k < count; k++)
+	    buf[k] = get_pixel(r.x + j + k, i);
+	  canvas->window_write(buf, count);
+	}
+      }
+      canvas->window_end();
+    }
+    mark_clean();
+  }
+
+  /**
+   * Copy the dirty pages (8 rows) of a monochrome off-screen canvas to
+   * the given page addressed LCD device (e.g. PCD8544 and ST7565) and
+   * mark as flushed. Only the dirty columns of each page are written
+   * with the device set_cursor() and draw_bitmap().
+   * @param[in] dev LCD device.
+   */
+  template<typename Device>
+  void flush_pages(Device* dev)
+  {
+    if ((DEPTH != 1) || !is_dirty()) return;
+    const rect16_t r = m_dirty;
+    uint8_t last = (r.y + r.height - 1) >> 3;
+    for (uint8_t line = (r.y >> 3); line <= last; line++) {
+      dev->set_cursor(r.x, line);
+      dev->draw_bitmap(&m_bitmap[(line * width) + r.x], r.width, CHARBITS);
+    }
+    mark_clean();
+  }
+
 private:
-  static const uint16_t COUNT = (width * height) / CHARBITS;
+  /** Size of off-screen buffer in bytes. */
+  static const uint16_t COUNT = (DEPTH == 1) ?
+    width * ((height + (CHARBITS - 1)) / CHARBITS) :
+    (width * height * (DEPTH / CHARBITS));
+
+  /** Off-screen buffer. */
   uint8_t m_bitmap[COUNT];
+
+  /** Dirty rectangle; width is zero when flushed. */
+  rect16_t m_dirty;
+
+  /**
+   * Return given color as RGB<3,3,2>.
+   * @param[in] color.
+   * @return 8-bit color.
+   */
+  static uint8_t rgb332(color16_t color)
+  {
+    return (((color.red >> 2) << 5) | ((color.green >> 3) << 2) | (color.blue >> 3));
+  }
+
+  /**
+   * Set pixel at given position to given color. Monochrome pixels
+   * are set for BLACK otherwise cleared.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] color.
+   */
+  void set_pixel(uint16_t x, uint16_t y, color16_t color)
+  {
+    if (DEPTH == 1) {
+      uint8_t* bp = &m_bitmap[((y >> 3) * width) + x];
+      uint8_t pos = (y & 0x07);
+      if (color.rgb == Canvas::BLACK)
+	*bp |= (1 << pos);
+      else
+	*bp &= ~(1 << pos);
+    }
+    else if (DEPTH == 8) {
+      m_bitmap[(y * width) + x] = rgb332(color);
+    }
+    else {
+      ((uint16_t*) m_bitmap)[(y * width) + x] = color.rgb;
+    }
+  }
 };
 
 #endif
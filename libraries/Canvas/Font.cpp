@@ -25,34 +25,20 @@ Font::draw(Canvas* canvas, char c, uint16_t x, uint16_t y,
            uint8_t scale)
 {
   Glyph glyph(this, c);
-
-  if (scale == 1) {
-    for (uint16_t i = 0; i < HEIGHT; i += 8) {
-      for (uint16_t j = 0; j < WIDTH; j++) {
-        uint8_t bits = glyph.next();
-        if (bits == 0xff) {
-          canvas->draw_vertical_line(x + j, y + i, CHARBITS);
-        }
-        else {
-          for (uint8_t k = 0; k < 8; k++) {
-            if (bits == 0) break;
-            if (bits & 1) canvas->draw_pixel(x + j, y + k + i);
-            bits >>= 1;
-          }
-        }
-      }
-    }
-  }
-  else {
-    for (uint16_t i = 0; i < HEIGHT; i += 8) {
-      for (uint16_t j = 0; j < WIDTH; j++) {
-        uint8_t bits = glyph.next();
-        for (uint8_t k = 0; k < 8; k++) {
-          if (bits == 0) break;
-          if (bits & 1) canvas->fill_rect(x + j*scale, y + (k+i)*scale, scale, scale);
-          bits >>= 1;
-        }
-      }
+  uint8_t width = WIDTH;
+  if (canvas->get_text_mode() == Canvas::OPAQUE_TEXT_MODE) width += SPACING;
+
+  // Draw the glyph as strips of 8 rows; decode columns to buffer
+  for (uint8_t i = 0; i < HEIGHT; i += CHARBITS) {
+    uint8_t height = HEIGHT - i;
+    if (height > CHARBITS) height = CHARBITS;
+    for (uint8_t j = 0; j < width; ) {
+      uint8_t buf[COLUMN_MAX];
+      uint8_t n = 0;
+      for (; n < COLUMN_MAX && j + n < width; n++)
+        buf[n] = (j + n < WIDTH) ? glyph.next() : 0;
+      canvas->draw_glyph(x + j*scale, y + i*scale, buf, n, height, scale);
+      j += n;
     }
   }
 }
@@ -82,9 +82,14 @@ public:
     return (c >= FIRST && c <= LAST);
   }
 
+  /** Max number of glyph columns per strip drawn on canvas. */
+  static const uint8_t COLUMN_MAX = 16;
+
   /**
    * @override{Font}
-   * Draw character on given canvas.
+   * Draw character on given canvas. The glyph is drawn as strips of
+   * 8 rows with Canvas::draw_glyph(). In opaque text mode the
+   * character spacing is also drawn.
    * @param[in] canvas.
    * @param[in] c character.
    * @param[in] x position.
@@ -0,0 +1,162 @@
+/**
+ * @file CosaCanvasBench.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa Canvas rendering benchmark with the frame buffer canvas.
+ * Measures execution time and driver operations (address windows,
+ * pixels and bus bytes) for text, lines, circles, images and scripts
+ * (interpreted and pre-decoded).
+ * The frame buffer requires 6 Kbyte; Arduino Mega. Define DUMP to
+ * write the final frame buffer as a PPM image on the serial output.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <Canvas.h>
+#include "Canvas/FrameBuffer.hh"
+
+#include <Font.h>
+#include "System5x7.hh"
+
+#include "Cosa/RTT.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+// #define DUMP
+
+FrameBuffer<64, 48> canvas;
+
+// Generated gradient image
+class Gradient : public Canvas::Image {
+public:
+  Gradient(uint16_t width, uint16_t height) :
+    Canvas::Image(width, height),
+    m_pos(0)
+  {}
+
+  virtual bool read(Canvas::color16_t* buf, size_t count)
+  {
+    while (count--) {
+      uint16_t x = m_pos % WIDTH;
+      uint16_t y = m_pos / WIDTH;
+      *buf++ = canvas.color(x << 2, y << 2, (x + y) << 1);
+      m_pos += 1;
+    }
+    return (true);
+  }
+
+private:
+  uint16_t m_pos;
+};
+
+// Script with filled and outlined primitives
+CANVAS_BEGIN_SCRIPT(script)
+  CANVAS_SET_CANVAS_COLOR(100, 100, 100)
+  CANVAS_FILL_SCREEN()
+  CANVAS_SET_PEN_COLOR(100, 100, 200)
+  CANVAS_SET_CURSOR(4, 4)
+  CANVAS_FILL_RECT(56, 16)
+  CANVAS_SET_PEN_COLOR(0, 0, 0)
+  CANVAS_DRAW_RECT(56, 16)
+  CANVAS_SET_CURSOR(8, 8)
+  CANVAS_DRAW_STRING(1)
+  CANVAS_SET_CURSOR(32, 34)
+  CANVAS_FILL_CIRCLE(10)
+  CANVAS_SET_PEN_COLOR(255, 255, 255)
+  CANVAS_DRAW_CIRCLE(10)
+  CANVAS_SET_CURSOR(4, 44)
+  CANVAS_DRAW_LINE(60, 24)
+CANVAS_END_SCRIPT
+
+const char msg[] __PROGMEM = "Cosa";
+
+const void_P table[] __PROGMEM = {
+  script,
+  msg
+};
+
+// Pre-decoded script
+Canvas::Script::command_t command[24];
+Canvas::Script compiled(command, membersof(command));
+
+void report(str_P name, uint32_t us)
+{
+  const FrameBuffer<64, 48>::stats_t& stats = canvas.stats();
+  trace << name
+	<< PSTR(": us=") << us
+	<< PSTR(", windows=") << stats.windows
+	<< PSTR(", pixels=") << stats.pixels
+	<< PSTR(", bytes=") << stats.bytes
+	<< endl;
+  canvas.reset();
+}
+
+#define BENCHMARK(name, stmt)			\
+  do {						\
+    canvas.reset();				\
+    uint32_t start = RTT::micros();		\
+    stmt;					\
+    uint32_t us = RTT::micros() - start;	\
+    report(PSTR(name), us);			\
+  } while (0)
+
+void setup()
+{
+  uart.begin(57600);
+  trace.begin(&uart, PSTR("CosaCanvasBench: started"));
+  Watchdog::begin();
+  RTT::begin();
+  canvas.begin();
+  canvas.set_text_font(&system5x7);
+  TRACE(canvas.compile(&compiled, 0, table, membersof(table)));
+}
+
+void loop()
+{
+  BENCHMARK("fill_screen", canvas.fill_screen());
+
+  canvas.set_text_mode(Canvas::TRANSPARENT_TEXT_MODE);
+  BENCHMARK("draw_string(transparent)", {
+      canvas.set_cursor(0, 0);
+      canvas.draw_string(PSTR("Hello World"));
+    });
+  canvas.set_text_mode(Canvas::OPAQUE_TEXT_MODE);
+  BENCHMARK("draw_string(opaque)", {
+      canvas.set_cursor(0, 8);
+      canvas.draw_string(PSTR("Hello World"));
+    });
+  canvas.set_text_mode(Canvas::TRANSPARENT_TEXT_MODE);
+
+  BENCHMARK("draw_line", {
+      for (uint16_t x = 0; x < canvas.WIDTH; x += 4)
+	canvas.draw_line(x, 0, canvas.WIDTH - 1 - x, canvas.HEIGHT - 1);
+    });
+  BENCHMARK("draw_circle", canvas.draw_circle(32, 24, 20));
+  BENCHMARK("fill_circle", canvas.fill_circle(32, 24, 20));
+
+  Gradient image(32, 32);
+  BENCHMARK("draw_image", canvas.draw_image(16, 8, &image));
+
+  BENCHMARK("run", canvas.run(0, table, membersof(table)));
+  BENCHMARK("run(compiled)", canvas.run(&compiled));
+
+#if defined(DUMP)
+  canvas.dump(trace);
+#endif
+  sleep(5);
+}
@@ -0,0 +1,228 @@
+/**
+ * @file CosaCanvasCheck.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa Canvas script check with the frame buffer canvas. Verifies
+ * that pre-decoded scripts render the same pixels as the script
+ * interpreter, and that running only the scripts that intersect a
+ * dirty region repairs the region with the same pixels as running
+ * all scripts (the skipped scripts change colors, text font and
+ * scale). Prints the result and exits with non-zero status on
+ * failure in the host build (build/host, make check).
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <Canvas.h>
+#include "Canvas/FrameBuffer.hh"
+
+#include <Font.h>
+#include "System5x7.hh"
+
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+FrameBuffer<64, 48> canvas;
+
+// Background
+CANVAS_BEGIN_SCRIPT(background)
+  CANVAS_SET_CANVAS_COLOR(0, 0, 64)
+  CANVAS_FILL_SCREEN()
+CANVAS_END_SCRIPT
+
+// Polygon, stroke, lines and adjacent spans in the upper part of the
+// screen
+CANVAS_BEGIN_SCRIPT(shapes)
+  CANVAS_SET_PEN_COLOR(255, 255, 0)
+  CANVAS_SET_CURSOR(2, 2)
+  CANVAS_DRAW_POLY(5, 2)
+  CANVAS_SET_CURSOR(30, 2)
+  CANVAS_DRAW_STROKE(6, 2)
+  CANVAS_SET_CURSOR(2, 20)
+  CANVAS_DRAW_LINE(20, 30)
+  CANVAS_DRAW_LINE(40, 20)
+  CANVAS_DRAW_LINE(40, 12)
+  CANVAS_DRAW_LINE(50, 12)
+  CANVAS_DRAW_LINE(60, 12)
+  CANVAS_SET_CURSOR(50, 14)
+  CANVAS_FILL_RECT(10, 2)
+  CANVAS_SET_CURSOR(50, 16)
+  CANVAS_FILL_RECT(10, 3)
+CANVAS_END_SCRIPT
+
+// State settings and text outside the dirty region
+CANVAS_BEGIN_SCRIPT(label)
+  CANVAS_SET_PEN_COLOR(255, 0, 0)
+  CANVAS_SET_TEXT_COLOR(0, 255, 0)
+  CANVAS_SET_TEXT_FONT(7)
+  CANVAS_SET_TEXT_SCALE(2)
+  CANVAS_SET_CURSOR(40, 34)
+  CANVAS_DRAW_STRING(4)
+CANVAS_END_SCRIPT
+
+// Drawing in the dirty region with the state of the previous scripts
+CANVAS_BEGIN_SCRIPT(marker)
+  CANVAS_SET_CURSOR(2, 36)
+  CANVAS_FILL_RECT(10, 4)
+  CANVAS_SET_CURSOR(12, 36)
+  CANVAS_FILL_RECT(4, 4)
+  CANVAS_SET_CURSOR(14, 32)
+  CANVAS_DRAW_CHAR('x')
+CANVAS_END_SCRIPT
+
+const char msg[] __PROGMEM = "Co";
+
+const int8_t square[] __PROGMEM = {
+  4, 0, 0, 4, -4, 0, 0, -4, 0, 0
+};
+
+const int8_t letter[] __PROGMEM = {
+  3, 3, 3, -3, -6, 0, 6, 0, 0, 0
+};
+
+const void_P table[] __PROGMEM = {
+  background,
+  shapes,
+  label,
+  marker,
+  msg,
+  square,
+  letter,
+  &system5x7
+};
+
+// Number of scripts in table
+const uint8_t SCRIPT_MAX = 4;
+
+// Pre-decoded scripts
+Canvas::Script::command_t command[SCRIPT_MAX][24];
+Canvas::Script compiled[SCRIPT_MAX] = {
+  Canvas::Script(command[0], membersof(command[0])),
+  Canvas::Script(command[1], membersof(command[1])),
+  Canvas::Script(command[2], membersof(command[2])),
+  Canvas::Script(command[3], membersof(command[3]))
+};
+Canvas::Script* const scripts[SCRIPT_MAX] = {
+  &compiled[0],
+  &compiled[1],
+  &compiled[2],
+  &compiled[3]
+};
+
+// Full screen and the dirty region (intersects background and marker)
+const Canvas::rect16_t screen = { 0, 0, 64, 48 };
+const Canvas::rect16_t dirty = { 0, 32, 28, 16 };
+
+static uint8_t failed = 0;
+
+/**
+ * Reset the canvas state to the state before running the scripts.
+ */
+void reset()
+{
+  canvas.set_canvas_color(canvas.color(0, 0, 0));
+  canvas.set_pen_color(canvas.color(255, 255, 255));
+  canvas.set_text_color(canvas.color(255, 255, 255));
+  canvas.set_text_font(&system5x7);
+  canvas.set_text_scale(1);
+  canvas.set_cursor(0, 0);
+}
+
+/**
+ * Return checksum of the pixels in the given region.
+ * @param[in] rect region.
+ * @return checksum.
+ */
+uint32_t checksum(const Canvas::rect16_t& rect)
+{
+  uint32_t sum = 0;
+  for (uint16_t y = rect.y; y < rect.y + rect.height; y++)
+    for (uint16_t x = rect.x; x < rect.x + rect.width; x++)
+      sum = (sum * 31) + canvas.get_pixel(x, y);
+  return (sum);
+}
+
+/**
+ * Check that the given checksums are equal and print the result.
+ * @param[in] name of check.
+ * @param[in] expected checksum.
+ * @param[in] actual checksum.
+ */
+void check(str_P name, uint32_t expected, uint32_t actual)
+{
+  trace << name << PSTR(": ");
+  if (expected == actual) {
+    trace << PSTR("ok") << endl;
+    return;
+  }
+  trace << PSTR("FAILED (expected=") << hex << expected
+	<< PSTR(", actual=") << hex << actual << ')' << endl;
+  failed += 1;
+}
+
+void setup()
+{
+  uart.begin(57600);
+  trace.begin(&uart, PSTR("CosaCanvasCheck: started"));
+  Watchdog::begin();
+  canvas.begin();
+
+  // Compile the scripts in order; each starts with the state left by
+  // the previous script
+  reset();
+  for (uint8_t ix = 0; ix < SCRIPT_MAX; ix++) {
+    int res = canvas.compile(&compiled[ix], ix, table, membersof(table));
+    if (res < 0) {
+      trace << PSTR("compile: FAILED (ix=") << ix
+	    << PSTR(", res=") << res << ')' << endl;
+      failed += 1;
+      return;
+    }
+    canvas.run(&compiled[ix]);
+  }
+}
+
+void loop()
+{
+  if (failed) exit(failed);
+
+  // Render with the script interpreter
+  reset();
+  for (uint8_t ix = 0; ix < SCRIPT_MAX; ix++)
+    canvas.run(ix, table, membersof(table));
+  uint32_t expected = checksum(screen);
+  uint32_t region = checksum(dirty);
+
+  // Render with the pre-decoded scripts
+  canvas.set_canvas_color(canvas.color(255, 0, 255));
+  canvas.fill_screen();
+  reset();
+  for (uint8_t ix = 0; ix < SCRIPT_MAX; ix++)
+    canvas.run(&compiled[ix]);
+  check(PSTR("run(compiled)"), expected, checksum(screen));
+
+  // Clear the dirty region and run only the intersecting scripts
+  canvas.set_pen_color(canvas.color(255, 0, 255));
+  canvas.fill_rect(dirty.x, dirty.y, dirty.width, dirty.height);
+  reset();
+  canvas.run(dirty, scripts, SCRIPT_MAX);
+  check(PSTR("run(dirty)"), region, checksum(dirty));
+
+  trace << (failed ? PSTR("FAILED") : PSTR("ok")) << endl;
+  exit(failed);
+}
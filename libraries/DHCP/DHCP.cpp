@@ -27,10 +27,26 @@ DHCP::DHCP(const char* hostname, const uint8_t* mac) :
   m_mac(mac),
   m_sock(NULL),
   m_lease_obtained(0L),
-  m_lease_expires(0L)
+  m_lease_expires(0L),
+  m_t1(0L),
+  m_t2(0L),
+  m_seconds(0L),
+  m_millis(0L),
+  m_ms(0)
 {
 }
 
+uint32_t
+DHCP::seconds()
+{
+  uint32_t now = Watchdog::millis();
+  uint32_t ms = m_ms + (now - m_millis);
+  m_millis = now;
+  m_seconds += ms / 1000;
+  m_ms = ms % 1000;
+  return (m_seconds);
+}
+
 int
 DHCP::send(uint8_t type)
 {
@@ -119,40 +135,62 @@ DHCP::recv(uint8_t type, uint16_t ms)
     delay(32);
   }
   if (UNLIKELY(res == 0)) return (ETIME);
+  return (parse(type));
+}
 
+int
+DHCP::parse(uint8_t type)
+{
   // Read response message
   header_t header;
   uint16_t port;
-  res = m_sock->recv(&header, sizeof(header), m_dhcp, port);
+  uint8_t buf[32];
+  int res = m_sock->recv(&header, sizeof(header), m_dhcp, port);
   if (UNLIKELY(res <= 0)) return (EIO);
   // Fix: Should also check that the hardware address (broadcast)
-  if (UNLIKELY(port != SERVER_PORT)) return (ENXIO);
-  if (UNLIKELY(header.OP != REPLY)) return (EBADR);
+  if (UNLIKELY(port != SERVER_PORT)) {
+    res = ENXIO;
+    goto flush;
+  }
+  if (UNLIKELY(header.OP != REPLY)) {
+    res = EBADR;
+    goto flush;
+  }
   memcpy(m_ip, header.YIADDR, sizeof(m_ip));
 
   // Skip legacy BOOTP parameters
-  uint8_t buf[32];
   for (uint8_t i = 0; i < 6; i++) m_sock->read(buf, sizeof(buf));
 
   // Check Magic Cookie
   uint32_t magic;
   res = m_sock->read(&magic, sizeof(magic));
-  if (UNLIKELY(res < 0)) return (EIO);
+  if (UNLIKELY(res < 0)) {
+    res = EIO;
+    goto flush;
+  }
   magic = ntoh((int32_t) magic);
-  if (UNLIKELY(magic != MAGIC_COOKIE)) return (EBADRQC);
+  if (UNLIKELY(magic != MAGIC_COOKIE)) {
+    res = EBADRQC;
+    goto flush;
+  }
 
-  // Parse options and collect; subnet mask, server addresses and lease time
+  // Parse options and collect; subnet mask, server addresses, lease
+  // and renewal times
   uint8_t op;
   uint8_t len;
   res = 0;
+  m_t1 = 0L;
+  m_t2 = 0L;
   while (m_sock->read(&op, sizeof(op)) == sizeof(op)) {
     if (op == END_OPTION) break;
     if (op == PAD_OPTION) continue;
     m_sock->read(&len, sizeof(len));
+    if (len > sizeof(buf)) len = sizeof(buf);
     m_sock->read(buf, len);
     switch (op) {
     case MESSAGE_TYPE:
-      if (buf[0] != type) res = -6;
+      if (buf[0] == DHCP_NAK) res = ECONNREFUSED;
+      else if (buf[0] != type) res = ENOMSG;
       break;
     case SUBNET_MASK:
       memcpy(m_subnet, buf, sizeof(m_subnet));
@@ -164,14 +202,20 @@ DHCP::recv(uint8_t type, uint16_t ms)
       memcpy(m_gateway, buf, sizeof(m_gateway));
       break;
     case IP_ADDR_LEASE_TIME:
-      m_lease_obtained = Watchdog::millis() / 1000;
-      int32_t* expire_p = (int32_t*) buf;
-      m_lease_expires = ntoh(*expire_p) + m_lease_obtained;
+      m_lease_obtained = seconds();
+      m_lease_expires = ntoh(*((int32_t*) buf)) + m_lease_obtained;
+      break;
+    case T1_VALUE:
+      m_t1 = ntoh(*((int32_t*) buf));
+      break;
+    case T2_VALUE:
+      m_t2 = ntoh(*((int32_t*) buf));
       break;
     };
   };
 
   // Flush any remains of the reply
+ flush:
   while (m_sock->available() > 0) m_sock->read(buf, sizeof(buf));
   return (res);
 }
@@ -248,3 +292,111 @@ DHCP::release(Socket* sock)
   return (0);
 }
 
+
+bool
+DHCP::Agent::begin(Socket* sock)
+{
+  if (UNLIKELY(!m_dhcp->begin(sock))) return (false);
+  m_state = INIT_STATE;
+  expire_at(time());
+  run();
+  reschedule();
+  return (true);
+}
+
+bool
+DHCP::Agent::end()
+{
+  stop();
+  m_state = IDLE_STATE;
+  return (m_dhcp->end());
+}
+
+void
+DHCP::Agent::run()
+{
+  uint32_t now = m_dhcp->seconds();
+  int res;
+
+  switch (m_state) {
+  case INIT_STATE:
+    send(DHCP_DISCOVER, SELECTING_STATE);
+    break;
+  case SELECTING_STATE:
+    if (m_dhcp->m_sock->available() > 0) {
+      res = m_dhcp->parse(DHCP_OFFER);
+      if (res == 0) {
+	send(DHCP_REQUEST, REQUESTING_STATE);
+	break;
+      }
+    }
+    if (Watchdog::millis() - m_start > TIMEOUT) m_state = INIT_STATE;
+    break;
+  case REQUESTING_STATE:
+    if (m_dhcp->m_sock->available() > 0) {
+      res = m_dhcp->parse(DHCP_ACK);
+      if (res == 0) {
+	bind();
+	break;
+      }
+      if (res == ECONNREFUSED) {
+	m_state = INIT_STATE;
+	break;
+      }
+    }
+    if (Watchdog::millis() - m_start > TIMEOUT) m_state = INIT_STATE;
+    break;
+  case BOUND_STATE:
+    if ((int32_t) (now - m_t1) >= 0) send(DHCP_REQUEST, RENEWING_STATE);
+    break;
+  case RENEWING_STATE:
+    if (m_dhcp->m_sock->available() > 0) {
+      res = m_dhcp->parse(DHCP_ACK);
+      if (res == 0) {
+	bind();
+	break;
+      }
+      if (res == ECONNREFUSED) {
+	m_state = INIT_STATE;
+	on_unbind();
+	break;
+      }
+    }
+    if ((int32_t) (now - m_dhcp->m_lease_expires) >= 0) {
+      m_state = INIT_STATE;
+      on_unbind();
+      break;
+    }
+    // Retry renewal; every fourth timeout period before T2 (renewing)
+    // and every timeout period after (rebinding)
+    if (Watchdog::millis() - m_start > ((int32_t) (now - m_t2) < 0 ?
+					 TIMEOUT * 4UL : TIMEOUT))
+      send(DHCP_REQUEST, RENEWING_STATE);
+    break;
+  }
+}
+
+void
+DHCP::Agent::send(uint8_t type, uint8_t state)
+{
+  m_start = Watchdog::millis();
+  m_state = (m_dhcp->send(type) < 0) ? INIT_STATE : state;
+}
+
+void
+DHCP::Agent::bind()
+{
+  // Calculate renewal and rebinding time; default 1/2 and 7/8 of lease.
+  // Limit lease time (infinite or not given) to allow time comparison
+  const uint32_t LEASE_MAX = 0x7fffffffUL;
+  uint32_t obtained = m_dhcp->m_lease_obtained;
+  uint32_t lease = m_dhcp->m_lease_expires - obtained;
+  if (lease == 0 || lease > LEASE_MAX) {
+    lease = LEASE_MAX;
+    m_dhcp->m_lease_expires = obtained + lease;
+  }
+  m_t1 = obtained + (m_dhcp->m_t1 != 0 ? m_dhcp->m_t1 : lease / 2);
+  m_t2 = obtained + (m_dhcp->m_t2 != 0 ? m_dhcp->m_t2 : lease - lease / 8);
+  m_state = BOUND_STATE;
+  on_bind(m_dhcp->m_ip, m_dhcp->m_subnet, m_dhcp->m_gateway);
+}
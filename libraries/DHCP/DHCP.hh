@@ -23,6 +23,7 @@
 
 #include "Cosa/Types.h"
 #include "Cosa/Socket.hh"
+#include "Cosa/Periodic.hh"
 
 /**
  * Dynamic Host Configuration Protocol. Supports dynamic assignment of
@@ -99,13 +100,22 @@ public:
    */
   int release(Socket* sock);
 
-  /** Return time when lease was obtained. */
+  /**
+   * Return lease clock; seconds since start. The clock accumulates
+   * the elapsed milli-seconds and does not wrap with the milli-second
+   * counter (49.7 days) as long as it is read within that period. The
+   * agent reads the clock every period.
+   * @return seconds.
+   */
+  uint32_t seconds();
+
+  /** Return time when lease was obtained (lease clock, seconds). */
   uint32_t lease_obtained() const
   {
     return (m_lease_obtained);
   }
 
-  /** Return time when lease will expire. */
+  /** Return time when lease will expire (lease clock, seconds). */
   uint32_t lease_expires() const
   {
     return (m_lease_expires);
@@ -129,6 +139,141 @@ public:
     return (m_gateway);
   }
 
+  /**
+   * DHCP client state machine. Runs discover and request without
+   * blocking and renews the lease at T1 (and until the lease expires)
+   * from the lease times given by the server. The agent is a periodic
+   * job and should be used with the Watchdog::Scheduler (milli-seconds).
+   * Sub-class and override on_bind() to apply the network address.
+   */
+  class Agent : public Periodic {
+  public:
+    /** Agent states. */
+    enum {
+      IDLE_STATE = 0,		//!< Not started.
+      INIT_STATE,		//!< Send discover.
+      SELECTING_STATE,		//!< Wait for offer.
+      REQUESTING_STATE,		//!< Wait for acknowledge.
+      BOUND_STATE,		//!< Lease obtained.
+      RENEWING_STATE		//!< Wait for renew acknowledge.
+    } __attribute__((packed));
+
+    /** Poll period (ms). */
+    static const uint16_t PERIOD = 128;
+
+    /** Response timeout (ms). */
+    static const uint16_t TIMEOUT = 2000;
+
+    /**
+     * Construct DHCP agent for given client with given job scheduler
+     * (milli-seconds).
+     * @param[in] scheduler job scheduler.
+     * @param[in] dhcp client.
+     */
+    Agent(Job::Scheduler* scheduler, DHCP* dhcp) :
+      Periodic(scheduler, PERIOD),
+      m_dhcp(dhcp),
+      m_state(IDLE_STATE),
+      m_start(0L),
+      m_t1(0L),
+      m_t2(0L)
+    {}
+
+    /**
+     * Start the agent with given connection-less socket on the DHCP
+     * client port. The socket is kept open to allow renewal. Returns
+     * true if successful otherwise false.
+     * @param[in] sock connection-less socket (UDP/DHCP::PORT).
+     * @return bool.
+     */
+    bool begin(Socket* sock);
+
+    /**
+     * Stop the agent and close the socket. The lease is not released.
+     * Returns true if successful otherwise false.
+     * @return bool.
+     */
+    bool end();
+
+    /**
+     * Return current agent state.
+     * @return state.
+     */
+    uint8_t state() const
+    {
+      return (m_state);
+    }
+
+    /**
+     * Return true(1) if a lease is bound otherwise false(0).
+     * @return bool.
+     */
+    bool is_bound() const
+    {
+      return (m_state == BOUND_STATE || m_state == RENEWING_STATE);
+    }
+
+    /**
+     * @override{DHCP::Agent}
+     * Called when a lease has been obtained or renewed with the
+     * given network address, subnet mask and gateway.
+     * @param[in] ip network address.
+     * @param[in] subnet mask.
+     * @param[in] gateway network address.
+     */
+    virtual void on_bind(const uint8_t ip[4],
+			 const uint8_t subnet[4],
+			 const uint8_t gateway[4])
+    {
+      UNUSED(ip);
+      UNUSED(subnet);
+      UNUSED(gateway);
+    }
+
+    /**
+     * @override{DHCP::Agent}
+     * Called when the lease expired without renewal. The agent
+     * restarts with discover.
+     */
+    virtual void on_unbind() {}
+
+  protected:
+    /** DHCP client. */
+    DHCP* m_dhcp;
+
+    /** Current state. */
+    uint8_t m_state;
+
+    /** Time of latest request (ms). */
+    uint32_t m_start;
+
+    /** Renewal time; T1 (seconds). */
+    uint32_t m_t1;
+
+    /** Rebinding time; T2 (seconds). */
+    uint32_t m_t2;
+
+    /**
+     * @override{Job}
+     * Run the state machine; check for responses and timeouts.
+     */
+    virtual void run();
+
+    /**
+     * Send message of given type and set next state. Restart on
+     * send error.
+     * @param[in] type DHCP message type option.
+     * @param[in] state next state.
+     */
+    void send(uint8_t type, uint8_t state);
+
+    /**
+     * Handle received acknowledge; calculate renewal times and call
+     * on_bind().
+     */
+    void bind();
+  };
+
 private:
   /** DHCP message OP code. */
   enum {
@@ -229,6 +374,21 @@ private:
   /** Lease expires. */
   uint32_t m_lease_expires;
 
+  /** Renewal time; T1 option (seconds, zero if not given). */
+  uint32_t m_t1;
+
+  /** Rebinding time; T2 option (seconds, zero if not given). */
+  uint32_t m_t2;
+
+  /** Lease clock (seconds). */
+  uint32_t m_seconds;
+
+  /** Milli-second counter at latest lease clock update. */
+  uint32_t m_millis;
+
+  /** Milli-seconds not yet accumulated to the lease clock. */
+  uint16_t m_ms;
+
   /** DHCP Server port numbers. */
   static const uint16_t SERVER_PORT = 67;
 
@@ -249,6 +409,16 @@ private:
    * @return zero if successful otherwise negative error code.
    */
   int recv(uint8_t type, uint16_t ms = 2000);
+
+  /**
+   * Read and parse available response of given type. The message is
+   * always consumed. Return zero if successful otherwise negative
+   * error code; ECONNREFUSED(-111) if negative acknowledge, ENOMSG(-42)
+   * if other message type.
+   * @param[in] type DHCP message type option.
+   * @return zero if successful otherwise negative error code.
+   */
+  int parse(uint8_t type);
 };
 
 #endif
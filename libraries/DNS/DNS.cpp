@@ -21,12 +21,16 @@
 #include "DNS.hh"
 #include "Cosa/INET.hh"
 #include "Cosa/Errno.h"
+#include "Cosa/Watchdog.hh"
+
+DNS::entry_t DNS::s_cache[DNS::CACHE_MAX];
 
 bool
 DNS::begin(Socket* sock, uint8_t server[4])
 {
   memcpy(m_server, server, sizeof(m_server));
   m_sock = sock;
+  m_retry = 0;
   return (sock != NULL);
 }
 
@@ -36,25 +40,102 @@ DNS::end()
   if (UNLIKELY(m_sock == NULL)) return (false);
   m_sock->close();
   m_sock = NULL;
+  m_retry = 0;
   return (true);
 }
 
 int
 DNS::gethostbyname(const char* hostname, uint8_t addr[4], bool progmem)
+{
+  int res = query(hostname, addr, progmem);
+  while (res == EINPROGRESS) {
+    delay(32);
+    res = poll(addr);
+  }
+  return (res);
+}
+
+int
+DNS::query(const char* hostname, uint8_t addr[4], bool progmem)
 {
   if (UNLIKELY(m_sock == NULL)) return (ENOTSOCK);
+  if (UNLIKELY(m_retry != 0)) return (EBUSY);
 
   // Check if we already have a network address (as a string)
   if (INET::aton(hostname, addr, progmem) == 0) return (0);
 
   // Convert hostname to a path
-  char path[INET::PATH_MAX];
-  int len = INET::nametopath(hostname, path, progmem);
+  int len = INET::nametopath(hostname, m_path, progmem);
   if (UNLIKELY(len <= 0)) return (EFAULT);
+  m_len = len;
+
+  // Check if the answer is cached
+  m_hash = hash(m_path, m_len);
+  entry_t* entry = lookup(m_hash, m_path, m_len);
+  if (entry != NULL) {
+    memcpy(addr, entry->ip, sizeof(entry->ip));
+    return (0);
+  }
+
+  // Send the request with a new identity
+  m_id += Watchdog::millis() | 1;
+  request();
+  return (EINPROGRESS);
+}
+
+int
+DNS::poll(uint8_t addr[4])
+{
+  if (UNLIKELY(m_sock == NULL)) return (ENOTSOCK);
+  if (UNLIKELY(m_retry == 0)) return (EINVAL);
+
+  // Check for response
+  if (m_sock->available() > 0) {
+    uint32_t ttl;
+    int res = response(addr, ttl);
+    if (res == 0) {
+      if (ttl != 0) {
+	if (ttl > TTL_MAX) ttl = TTL_MAX;
+	entry_t* entry = lookup(m_hash, m_path, m_len);
+	if (entry == NULL) {
+	  // Replace the entry that expires first
+	  uint32_t now = Watchdog::millis();
+	  entry = s_cache;
+	  for (uint8_t i = 1; i < CACHE_MAX; i++)
+	    if ((int32_t) (s_cache[i].expires - now)
+		< (int32_t) (entry->expires - now))
+	      entry = &s_cache[i];
+	}
+	entry->hash = m_hash;
+	entry->len = m_len;
+	memcpy(entry->path, m_path, m_len);
+	memcpy(entry->ip, addr, sizeof(entry->ip));
+	entry->expires = Watchdog::millis() + ttl * 1000UL;
+      }
+      return (complete(0));
+    }
+    if (res != ENOMSG) return (complete(res));
+  }
+
+  // Check for timeout; resend request or give up
+  if (Watchdog::millis() - m_start < TIMEOUT) return (EINPROGRESS);
+  if (m_retry == RETRY_MAX) return (complete(EIO));
+  request();
+  return (EINPROGRESS);
+}
+
+void
+DNS::flush()
+{
+  memset(s_cache, 0, sizeof(s_cache));
+}
 
+void
+DNS::request()
+{
   // Construct request header
   header_t request;
-  request.ID = hton((int16_t) ID);
+  request.ID = hton((int16_t) m_id);
   request.FC = hton(QUERY_FLAG | OPCODE_STANDARD_QUERY | RECURSION_DESIRED_FLAG);
   request.QC = hton(1);
   request.ANC = 0;
@@ -66,64 +147,107 @@ DNS::gethostbyname(const char* hostname, uint8_t addr[4], bool progmem)
   attr.TYPE = hton(TYPE_A);
   attr.CLASS = hton(CLASS_IN);
 
-  // Send request and wait for reply
-  for (int8_t retry = 0; retry < RETRY_MAX; retry++) {
-    m_sock->datagram(m_server, PORT);
-    m_sock->write(&request, sizeof(request));
-    m_sock->write(path, len);
-    m_sock->write(&attr, sizeof(attr));
-    m_sock->flush();
-
-    // Wait for a reply
-    int res;
-    for (uint16_t i = 0; i < TIMEOUT; i += 32) {
-      if ((res = m_sock->available()) != 0) break;
-      delay(32);
-    }
-    if (res == 0) continue;
-
-    // Receive the DNS response
-    uint8_t response[128];
-    uint8_t dest[4];
-    uint16_t port;
-    res = m_sock->recv(response, sizeof(response), dest, port);
-    if (UNLIKELY(res <= 0)) continue;
-
-    // The response header
-    header_t* header = (header_t*) response;
-    ntoh((int16_t*) header, (int16_t*) header, sizeof(header_t) / 2);
-    if (header->ID != ID) continue;
-    uint8_t* ptr = &response[sizeof(header_t)];
-
-    // The query; Path and attributes
-    uint8_t n;
-    while ((n = *ptr++) != 0) ptr += n;
-    ptr += sizeof(attr_t);
-
-    // The answer; domain name, attributes and data (address)
-    for (uint16_t i = 0; i < header->ANC; i++) {
-      do {
-	n = *ptr++;
-	if ((n & LABEL_COMPRESSION_MASK) == 0) {
-	  if ((n & 0x80) == 0) {
-	    ptr += n;
-	  }
-	}
-	else {
-	  ptr += 1;
-	  n = 0;
+  // Send request
+  m_sock->datagram(m_server, PORT);
+  m_sock->write(&request, sizeof(request));
+  m_sock->write(m_path, m_len);
+  m_sock->write(&attr, sizeof(attr));
+  m_sock->flush();
+  m_start = Watchdog::millis();
+  m_retry += 1;
+}
+
+int
+DNS::response(uint8_t addr[4], uint32_t& ttl)
+{
+  // Receive the DNS response
+  uint8_t response[128];
+  uint8_t dest[4];
+  uint16_t port;
+  int res = m_sock->recv(response, sizeof(response), dest, port);
+  if (UNLIKELY(res <= 0)) return (ENOMSG);
+
+  // The response header
+  header_t* header = (header_t*) response;
+  ntoh((int16_t*) header, (int16_t*) header, sizeof(header_t) / 2);
+  if (header->ID != m_id) return (ENOMSG);
+  if ((header->FC & QUERY_RESPONSE_MASK) != RESPONSE_FLAG) return (ENOMSG);
+  uint8_t* ptr = &response[sizeof(header_t)];
+
+  // The query; Path and attributes. Should match the request
+  if (header->QC != 1) return (ENOMSG);
+  if (sizeof(header_t) + m_len + sizeof(attr_t) > (size_t) res)
+    return (ENOMSG);
+  if (memcmp(ptr, m_path, m_len) != 0) return (ENOMSG);
+  ptr += m_len + sizeof(attr_t);
+  uint8_t n;
+
+  // The answer; domain name, attributes and data (address). Check
+  // that each field is within the response before reading it
+  uint8_t* end = response + res;
+  for (uint16_t i = 0; i < header->ANC; i++) {
+    do {
+      if (ptr >= end) return (ENOENT);
+      n = *ptr++;
+      if ((n & LABEL_COMPRESSION_MASK) == 0) {
+	if ((n & 0x80) == 0) {
+	  ptr += n;
 	}
-      } while (n != 0);
-      rec_t* rec = (rec_t*) ptr;
-      ntoh((int16_t*) rec, (int16_t*) rec, sizeof(rec_t) / 2);
-      ptr += sizeof(rec_t);
-      ptr += rec->RDL;
-      if (rec->TYPE != TYPE_A) continue;
-      if (rec->CLASS != CLASS_IN) continue;
-      if (rec->RDL != INET::IP_MAX) continue;
-      memcpy(addr, rec->RD, INET::IP_MAX);
-      return (0);
-    }
+      }
+      else {
+	ptr += 1;
+	n = 0;
+      }
+    } while (n != 0);
+    if (ptr + sizeof(rec_t) > end) break;
+    rec_t* rec = (rec_t*) ptr;
+    ttl = ((uint32_t) ptr[4] << 24) | ((uint32_t) ptr[5] << 16)
+      | ((uint16_t) ptr[6] << 8) | ptr[7];
+    ntoh((int16_t*) rec, (int16_t*) rec, sizeof(rec_t) / 2);
+    ptr += sizeof(rec_t);
+    if (rec->RDL > end - ptr) break;
+    ptr += rec->RDL;
+    if (rec->TYPE != TYPE_A) continue;
+    if (rec->CLASS != CLASS_IN) continue;
+    if (rec->RDL != INET::IP_MAX) continue;
+    memcpy(addr, rec->RD, INET::IP_MAX);
+    return (0);
+  }
+  return (ENOENT);
+}
+
+int
+DNS::complete(int res)
+{
+  m_retry = 0;
+  if (m_handler != NULL)
+    Event::push(Event::RECEIVE_COMPLETED_TYPE, m_handler, (uint16_t) res);
+  return (res);
+}
+
+uint32_t
+DNS::hash(const char* path, uint8_t len)
+{
+  // FNV-1a hash
+  uint32_t res = 2166136261UL;
+  while (len--) {
+    res ^= (uint8_t) *path++;
+    res *= 16777619UL;
+  }
+  return (res);
+}
+
+DNS::entry_t*
+DNS::lookup(uint32_t hash, const char* path, uint8_t len)
+{
+  uint32_t now = Watchdog::millis();
+  for (uint8_t i = 0; i < CACHE_MAX; i++) {
+    entry_t* entry = &s_cache[i];
+    if (entry->len != len || entry->hash != hash) continue;
+    if (memcmp(entry->path, path, len) != 0) continue;
+    if ((int32_t) (entry->expires - now) > 0) return (entry);
+    entry->len = 0;
+    return (NULL);
   }
-  return (EIO);
+  return (NULL);
 }
@@ -22,22 +22,44 @@
 #define COSA_INET_DNS_HH
 
 #include "Cosa/Types.h"
+#include "Cosa/Event.hh"
 #include "Cosa/Socket.hh"
+#include "Cosa/INET.hh"
+
+// Default number of cached answers
+#ifndef COSA_DNS_CACHE_MAX
+# define COSA_DNS_CACHE_MAX 4
+#endif
 
 /**
  * Domain Name Server request handler. Allows mapping from symbolic
  * human readable names in dot notation to network addresses.
+ *
+ * Lookup may be blocking, gethostbyname(), or asynchronous with
+ * query() and poll(). Answers are kept in a cache shared by all
+ * handlers until the record time to live (max TTL_MAX) has expired.
  */
 class DNS {
 public:
   /** DNS standard port number. */
   static const uint16_t PORT = 53;
 
+  /** Number of cached answers (each holds the hostname path). */
+  static const uint8_t CACHE_MAX = COSA_DNS_CACHE_MAX;
+
+  /** Max time to live for cached answers (seconds). */
+  static const uint32_t TTL_MAX = 3600;
+
   /**
    * Construct DNS request handler. Use begin() to initiate the
    * handler and end() to terminate.
    */
-  DNS() {}
+  DNS() :
+    m_sock(NULL),
+    m_handler(NULL),
+    m_retry(0),
+    m_id(0)
+  {}
 
   /**
    * Construct DNS request handler and initiate with given UDP socket and
@@ -45,7 +67,11 @@ public:
    * @param[in] sock socket.
    * @param[in] server network address.
    */
-  DNS(Socket* sock, uint8_t server[4])
+  DNS(Socket* sock, uint8_t server[4]) :
+    m_sock(NULL),
+    m_handler(NULL),
+    m_retry(0),
+    m_id(0)
   {
     begin(sock, server);
   }
@@ -99,6 +125,75 @@ public:
     return (gethostbyname((const char*) hostname, ip, true));
   }
 
+  /**
+   * Start lookup of the given hostname. Returns zero if the network
+   * address is available directly (dot notation or cached) and
+   * written to the given buffer, EINPROGRESS(-115) if a request was
+   * sent, otherwise a negative error code. Use poll() to check for
+   * the answer.
+   * @param[in] hostname to lookup.
+   * @param[in] ip network address.
+   * @return zero, EINPROGRESS or negative error code.
+   */
+  int query(const char* hostname, uint8_t ip[4])
+    __attribute__((always_inline))
+  {
+    return (query(hostname, ip, false));
+  }
+
+  /**
+   * Start lookup of the given hostname. Returns zero if the network
+   * address is available directly (dot notation or cached) and
+   * written to the given buffer, EINPROGRESS(-115) if a request was
+   * sent, otherwise a negative error code. Use poll() to check for
+   * the answer.
+   * @param[in] hostname to lookup (in program memory).
+   * @param[in] ip network address.
+   * @return zero, EINPROGRESS or negative error code.
+   */
+  int query_P(str_P hostname, uint8_t ip[4])
+    __attribute__((always_inline))
+  {
+    return (query((const char*) hostname, ip, true));
+  }
+
+  /**
+   * Check for answer to pending lookup. Does not block; the request
+   * is sent again after a timeout. Returns zero if the answer was
+   * received and the network address written to the given buffer,
+   * EINPROGRESS(-115) if still waiting, otherwise a negative error
+   * code; ENOENT(-2) no address for hostname, EIO(-5) no response,
+   * EINVAL(-22) no pending lookup. An event (RECEIVE_COMPLETED_TYPE)
+   * with the result as value is pushed to the event handler, if
+   * given, on completion.
+   * @param[in] ip network address.
+   * @return zero, EINPROGRESS or negative error code.
+   */
+  int poll(uint8_t ip[4]);
+
+  /**
+   * Return true(1) if a lookup is pending otherwise false(0).
+   * @return bool.
+   */
+  bool is_pending() const
+  {
+    return (m_retry != 0);
+  }
+
+  /**
+   * Set event handler for completion of asynchronous lookup.
+   * @param[in] handler event handler (or NULL).
+   */
+  void event_handler(Event::Handler* handler)
+  {
+    m_handler = handler;
+  }
+
+  /**
+   * Remove all cached answers.
+   */
+  static void flush();
+
 private:
   /**
    * Header Flags and Codes (little-endian).
@@ -156,11 +251,29 @@ private:
     uint8_t RD[];		//!< Resource Data.
   };
 
+  /** Cached answer. */
+  struct entry_t {
+    uint32_t hash;		//!< Hash of hostname path.
+    uint8_t len;		//!< Length of hostname path (zero if free).
+    char path[INET::PATH_MAX];	//!< Hostname path.
+    uint8_t ip[4];		//!< Network address.
+    uint32_t expires;		//!< Expire time (ms).
+  };
+
   static const uint16_t TIMEOUT = 300;
   static const uint8_t RETRY_MAX = 8;
-  static const uint16_t ID = 0xC05AU;
   uint8_t m_server[4];
   Socket* m_sock;
+  Event::Handler* m_handler;	//!< Completion event handler.
+  uint8_t m_retry;		//!< Number of requests sent; zero when idle.
+  uint32_t m_start;		//!< Time of latest request (ms).
+  uint16_t m_id;		//!< Identity of pending request.
+  uint32_t m_hash;		//!< Hash of pending hostname path.
+  uint8_t m_len;		//!< Length of pending hostname path.
+  char m_path[INET::PATH_MAX];	//!< Pending hostname path.
+
+  /** Cached answers; shared by all request handlers. */
+  static entry_t s_cache[CACHE_MAX];
 
   /**
    * Lookup the given hostname and return the network address. Returns
@@ -171,5 +284,58 @@ private:
    * @return zero if successful otherwise negative error code.
    */
   int gethostbyname(const char* hostname, uint8_t ip[4], bool progmem);
+
+  /**
+   * Start lookup of the given hostname. Returns zero if available
+   * directly, EINPROGRESS if request sent, otherwise negative error
+   * code.
+   * @param[in] hostname to lookup.
+   * @param[in] ip network address.
+   * @param[in] progmem flag if hostname string in program memory.
+   * @return zero, EINPROGRESS or negative error code.
+   */
+  int query(const char* hostname, uint8_t ip[4], bool progmem);
+
+  /**
+   * Send request for pending hostname path.
+   */
+  void request();
+
+  /**
+   * Receive and parse response. Returns zero if an address record
+   * was found, ENOMSG(-42) if not a response to the request (identity
+   * or question does not match), ENOENT(-2) if no address record.
+   * @param[in] ip network address.
+   * @param[out] ttl time to live (seconds).
+   * @return zero or negative error code.
+   */
+  int response(uint8_t ip[4], uint32_t& ttl);
+
+  /**
+   * Complete pending lookup with given result. Push event to handler
+   * if given. Returns result.
+   * @param[in] res result code.
+   * @return result code.
+   */
+  int complete(int res);
+
+  /**
+   * Return hash (FNV-1a, 32-bit) of given path with given length.
+   * @param[in] path hostname path.
+   * @param[in] len length of path.
+   * @return hash.
+   */
+  static uint32_t hash(const char* path, uint8_t len);
+
+  /**
+   * Lookup cached answer for given hostname path. The hash and
+   * length are compared first and then the path. Return pointer to
+   * entry or NULL if not found or expired.
+   * @param[in] hash of hostname path.
+   * @param[in] path hostname path.
+   * @param[in] len length of hostname path.
+   * @return entry or NULL.
+   */
+  static entry_t* lookup(uint32_t hash, const char* path, uint8_t len);
 };
 #endif
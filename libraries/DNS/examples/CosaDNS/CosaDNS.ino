@@ -94,5 +94,18 @@ void loop()
   INET::print_addr(trace, host);
   trace.println();
 
+  // Asynchronous lookup; answer from cache or poll while waiting
+  uint16_t polls = 0;
+  int res = dns.query_P(NAME, host);
+  while (res == EINPROGRESS) {
+    delay(16);
+    polls += 1;
+    res = dns.poll(host);
+  }
+  ASSERT(res == 0);
+  trace << PSTR(":query(") << NAME << PSTR(") = ");
+  INET::print_addr(trace, host);
+  trace << PSTR(", polls = ") << polls << endl;
+
   sleep(10);
 }
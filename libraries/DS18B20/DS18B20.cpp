@@ -19,6 +19,7 @@
  */
 
 #include "DS18B20.hh"
+#include "Cosa/Errno.h"
 #include "Cosa/Watchdog.hh"
 
 DS18B20*
@@ -145,3 +146,142 @@ IOStream& operator<<(IOStream& outs, DS18B20& thermometer)
   return (outs);
 }
 
+
+bool
+DS18B20::Manager::sample_request(uint8_t resolution, bool parasite)
+{
+  if (UNLIKELY(m_state != IDLE_STATE)) return (false);
+  if (resolution < 9) resolution = 9;
+  else if (resolution > 12) resolution = 12;
+  m_conversion = (MAX_CONVERSION_TIME >> (12 - resolution));
+  m_parasite = parasite;
+  m_invalid = 0UL;
+  m_errors = 0;
+
+#if defined(TIMER2_COMPA_vect)
+  // Broadcast convert request; completion event starts the wait
+  m_cmd[0] = OWI::SKIP_ROM;
+  m_cmd[1] = CONVERT_T;
+  if (m_owi->transfer(m_cmd, 2, NULL, 0, this, true, parasite) < 0)
+    return (false);
+  m_state = CONVERT_STATE;
+#else
+  // Broadcast convert request and wait for conversion
+  if (!DS18B20::convert_request(m_owi, 0, parasite)) return (false);
+  m_state = WAIT_STATE;
+  expire_at(time() + m_conversion);
+  start();
+#endif
+  return (true);
+}
+
+void
+DS18B20::Manager::on_event(uint8_t type, uint16_t value)
+{
+  if (type != Event::COMMAND_COMPLETED_TYPE) {
+    Job::on_event(type, value);
+    return;
+  }
+  int res = (int) value;
+  switch (m_state) {
+  case CONVERT_STATE:
+    // Convert request done; wait for conversion time
+    if (UNLIKELY(res < 0)) {
+      m_state = IDLE_STATE;
+      m_errors = m_count;
+      m_invalid = ~0UL;
+      on_completed(m_errors);
+      return;
+    }
+    m_state = WAIT_STATE;
+    expire_at(time() + m_conversion);
+    start();
+    break;
+  case READ_STATE:
+    // Scratchpad read; check size, configuration bits and crc
+    {
+      DS18B20* sensor = m_sensor[m_ix];
+      read_done((res == sizeof(sensor->m_scratchpad))
+		&& (m_owi->crc() == 0)
+		&& ((sensor->m_scratchpad.configuration & 0x1f) == 0x1f));
+      if (m_retry != 0)
+	retry();
+      else
+	read_next();
+    }
+    break;
+  }
+}
+
+void
+DS18B20::Manager::run()
+{
+  // Conversion time expired; start reading. Otherwise retry reading
+  if (m_state == WAIT_STATE) {
+    if (m_parasite) m_owi->power_off();
+    m_state = READ_STATE;
+    m_ix = 0;
+    m_retry = 0;
+  }
+  read_next();
+}
+
+void
+DS18B20::Manager::retry()
+{
+  expire_at(time() + RETRY_DELAY);
+  start();
+}
+
+void
+DS18B20::Manager::read_next()
+{
+  while (m_ix < m_count) {
+    DS18B20* sensor = m_sensor[m_ix];
+
+#if defined(TIMER2_COMPA_vect)
+    // Address the thermometer and read the scratchpad asynchronously;
+    // continued on completion event
+    m_cmd[0] = OWI::MATCH_ROM;
+    memcpy(&m_cmd[1], sensor->m_rom, OWI::ROM_MAX);
+    m_cmd[OWI::ROM_MAX + 1] = READ_SCRATCHPAD;
+    int res = m_owi->transfer(m_cmd, sizeof(m_cmd),
+			      &sensor->m_scratchpad,
+			      sizeof(sensor->m_scratchpad),
+			      this);
+    if (res == 0) return;
+
+    // The bus is in use; try again later without counting an attempt
+    if (res == EBUSY) {
+      retry();
+      return;
+    }
+    read_done(false);
+#else
+    read_done(sensor->read_scratchpad());
+#endif
+
+    // Failed reading; try again later
+    if (m_retry != 0) {
+      retry();
+      return;
+    }
+  }
+
+  // All thermometers have been read
+  m_state = IDLE_STATE;
+  on_completed(m_errors);
+}
+
+void
+DS18B20::Manager::read_done(bool valid)
+{
+  // Retry failed reading; mark as invalid after max attempts
+  if (!valid) {
+    if (++m_retry < RETRY_MAX) return;
+    m_invalid |= (1UL << m_ix);
+    m_errors += 1;
+  }
+  m_ix += 1;
+  m_retry = 0;
+}
@@ -25,6 +25,7 @@
 
 #include "Cosa/Types.h"
 #include "Cosa/IOStream.hh"
+#include "Cosa/Job.hh"
 
 /**
  * Driver for the DS18B20 Programmable Resolution 1-Write Digital
@@ -48,6 +49,9 @@
  */
 class DS18B20 : public OWI::Driver {
 public:
+  /** Bus-level conversion and collection manager; see below. */
+  class Manager;
+
   /**
    * Alarm search support class.
    */
@@ -299,6 +303,151 @@ protected:
   friend IOStream& operator<<(IOStream& outs, DS18B20& thermometer);
 };
 
+/**
+ * Bus-level conversion and collection of DS18B20 readings. A single
+ * SKIP ROM convert request is issued to all thermometers on the bus.
+ * The conversion time, given by the resolution, is awaited with a
+ * job (milli-seconds scheduler, e.g. Watchdog::Scheduler). The
+ * scratchpads are then read one after the other with CRC check and
+ * retry. The reads are performed with asynchronous OWI transactions
+ * when available. All readings are reported with one callback,
+ * on_completed().
+ *
+ * @section Limitations
+ * Max SENSOR_MAX thermometers. The thermometers should be connected
+ * (have rom identity) before sampling.
+ */
+class DS18B20::Manager : public Job {
+public:
+  /** Max number of read attempts per thermometer. */
+  static const uint8_t RETRY_MAX = 3;
+
+  /** Delay before a read attempt is retried (ms). */
+  static const uint16_t RETRY_DELAY = 16;
+
+  /** Max number of thermometers. */
+  static const uint8_t SENSOR_MAX = 32;
+
+  /**
+   * Construct manager for the given thermometers on one-wire bus
+   * and job scheduler (milli-seconds).
+   * @param[in] scheduler job scheduler.
+   * @param[in] owi one-wire bus.
+   * @param[in] sensors vector with thermometers.
+   * @param[in] count number of thermometers.
+   */
+  Manager(Job::Scheduler* scheduler, OWI* owi,
+	  DS18B20** sensors, uint8_t count) :
+    Job(scheduler),
+    m_owi(owi),
+    m_sensor(sensors),
+    m_count(count > SENSOR_MAX ? SENSOR_MAX : count),
+    m_state(IDLE_STATE),
+    m_ix(0),
+    m_retry(0),
+    m_errors(0),
+    m_conversion(0),
+    m_parasite(false),
+    m_invalid(0UL)
+  {}
+
+  /**
+   * Request conversion of all thermometers with given resolution and
+   * parasite power mode, and collect readings. Returns true(1) if
+   * started otherwise false(0); busy or no device presence.
+   * @param[in] resolution of conversion (Default 12).
+   * @param[in] parasite power mode flag (Default false).
+   * @return bool.
+   */
+  bool sample_request(uint8_t resolution = 12, bool parasite = false);
+
+  /**
+   * Return true(1) if sampling is in progress otherwise false(0).
+   * @return bool.
+   */
+  bool is_busy() const
+  {
+    return (m_state != IDLE_STATE);
+  }
+
+  /**
+   * Return true(1) if the latest reading of the thermometer with the
+   * given index is valid otherwise false(0).
+   * @param[in] ix thermometer index.
+   * @return bool.
+   */
+  bool is_valid(uint8_t ix) const
+  {
+    return ((ix < m_count) && ((m_invalid & (1UL << ix)) == 0));
+  }
+
+  /**
+   * @override{DS18B20::Manager}
+   * Callback when all thermometers have been read. The readings are
+   * available with DS18B20::temperature(). Default is empty function.
+   * @param[in] errors number of failed readings.
+   */
+  virtual void on_completed(uint8_t errors)
+  {
+    UNUSED(errors);
+  }
+
+  /**
+   * @override{Event::Handler}
+   * Handle completion of one-wire transactions and timeout.
+   * @param[in] type the type of event.
+   * @param[in] value the event value.
+   */
+  virtual void on_event(uint8_t type, uint16_t value);
+
+  /**
+   * @override{Job}
+   * Conversion time expired; start reading scratchpads. Or retry
+   * delay expired; read the current thermometer again.
+   */
+  virtual void run();
+
+protected:
+  /** Sampling states. */
+  enum {
+    IDLE_STATE,			//!< Not sampling.
+    CONVERT_STATE,		//!< Convert request in progress.
+    WAIT_STATE,			//!< Waiting for conversion.
+    READ_STATE			//!< Reading scratchpads.
+  } __attribute__((packed));
+
+  OWI* m_owi;			//!< One-wire bus.
+  DS18B20** m_sensor;		//!< Thermometers.
+  uint8_t m_count;		//!< Number of thermometers.
+  uint8_t m_state;		//!< Sampling state.
+  uint8_t m_ix;			//!< Current thermometer (index).
+  uint8_t m_retry;		//!< Read attempts for current.
+  uint8_t m_errors;		//!< Number of failed readings.
+  uint16_t m_conversion;	//!< Conversion time (ms).
+  bool m_parasite;		//!< Parasite power mode.
+  uint32_t m_invalid;		//!< Failed readings (bitset).
+  uint8_t m_cmd[OWI::ROM_MAX + 2]; //!< Command; match rom and read.
+
+  /**
+   * Read scratchpad of current thermometer, or complete sampling
+   * when all thermometers have been read.
+   */
+  void read_next();
+
+  /**
+   * Schedule another read attempt of the current thermometer after
+   * the retry delay (RETRY_DELAY).
+   */
+  void retry();
+
+  /**
+   * Handle result of current read; retry or advance to next
+   * thermometer.
+   * @param[in] valid reading.
+   */
+  void read_done(bool valid);
+};
+
 /**
  * Print the name of the thermometer and latest temperature reading
  * with two decimals to given output stream. The temperature is in
@@ -0,0 +1,95 @@
+/**
+ * @file CosaDS18B20manager.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa demonstrate the DS18B20 bus manager; one broadcast conversion
+ * and collected reads of all thermometers on the bus.
+ *
+ * @section Circuit
+ * Connect three DS18B20 to the 1-Wire bus in D7 with a 4K7 pullup
+ * resistor to VCC.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <OWI.h>
+#include <DS18B20.h>
+
+#include "Cosa/Event.hh"
+#include "Cosa/Periodic.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+// One-wire pin and connected thermometers
+OWI owi(Board::D7);
+DS18B20 indoors(&owi);
+DS18B20 outdoors(&owi);
+DS18B20 basement(&owi);
+DS18B20* sensor[] = { &indoors, &outdoors, &basement };
+
+Watchdog::Scheduler scheduler;
+
+class Manager : public DS18B20::Manager {
+public:
+  Manager() :
+    DS18B20::Manager(&scheduler, &owi, sensor, membersof(sensor))
+  {}
+
+  virtual void on_completed(uint8_t errors)
+  {
+    trace << Watchdog::millis() << ':';
+    for (uint8_t i = 0; i < membersof(sensor); i++) {
+      if (is_valid(i))
+	trace << ' ' << *sensor[i];
+      else
+	trace << PSTR(" -");
+    }
+    trace << PSTR(" (errors=") << errors << ')' << endl;
+  }
+};
+
+Manager manager;
+
+class Sampler : public Periodic {
+public:
+  Sampler() : Periodic(&scheduler, 2048) {}
+
+  virtual void run()
+  {
+    if (!manager.is_busy()) manager.sample_request();
+  }
+};
+
+Sampler sampler;
+
+void setup()
+{
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaDS18B20manager: started"));
+  Watchdog::begin();
+
+  // Connect to the thermometers and start sampling
+  for (uint8_t i = 0; i < membersof(sensor); i++)
+    ASSERT(sensor[i]->connect(i));
+  sampler.start();
+}
+
+void loop()
+{
+  Event::service();
+}
@@ -96,10 +96,9 @@ GDDRAM::draw_pixel(uint16_t x, uint16_t y)
 }
 
 void
-GDDRAM::draw_image(uint16_t x, uint16_t y, Image* image)
+GDDRAM::window_begin(uint16_t x, uint16_t y, uint16_t width, uint16_t height)
 {
-  uint16_t width = image->WIDTH;
-  uint16_t height = image->HEIGHT;
+  // The bus is released between writes; the memory write continues
   spi.acquire(this);
     spi.begin();
       write(CASET, x, x + width - 1);
@@ -107,19 +106,68 @@ GDDRAM::draw_image(uint16_t x, uint16_t y, Image* image)
       write(RAMWR);
     spi.end();
   spi.release();
-  for (uint16_t i = 0; i < height; i++) {
-    color16_t buf[Image::BUFFER_MAX];
-    size_t count;
-    for (uint16_t j = 0; j < width; j += count) {
-      count = (width - j > Image::BUFFER_MAX) ? Image::BUFFER_MAX : width - j;
-      image->read(buf, count);
-      spi.acquire(this);
-        spi.begin();
-	for (uint16_t k = 0; k < count; k++) write(buf[k]);
-	spi.end();
-      spi.release();
-    }
+}
+
+void
+GDDRAM::window_write(const color16_t* buf, size_t count)
+{
+  if (UNLIKELY(count == 0)) return;
+  spi.acquire(this);
+    spi.begin();
+      spi.transfer_start(buf->rgb >> 8);
+      spi.transfer_next(buf->rgb);
+      while (--count) {
+	buf++;
+	spi.transfer_next(buf->rgb >> 8);
+	spi.transfer_next(buf->rgb);
+      }
+      spi.transfer_await();
+    spi.end();
+  spi.release();
+}
+
+void
+GDDRAM::window_fill(color16_t color, uint16_t count)
+{
+  if (UNLIKELY(count == 0)) return;
+  spi.acquire(this);
+    spi.begin();
+      write(color.rgb, count);
+    spi.end();
+  spi.release();
+}
+
+void
+GDDRAM::draw_glyph(uint16_t x, uint16_t y, const uint8_t* bp,
+		   uint8_t width, uint8_t height,
+		   uint8_t scale)
+{
+  // Use spans for transparent text and clipping
+  uint16_t w = width * scale;
+  uint16_t h = height * scale;
+  if ((get_text_mode() != OPAQUE_TEXT_MODE)
+      || ((x + w) > WIDTH) || ((y + h) > HEIGHT)) {
+    Canvas::draw_glyph(x, y, bp, width, height, scale);
+    return;
   }
+
+  // Write the strip as a single address window; row by row
+  if (UNLIKELY((w == 0) || (h == 0))) return;
+  const color16_t fg = get_pen_color();
+  const color16_t bg = get_canvas_color();
+  spi.acquire(this);
+    spi.begin();
+      write(CASET, x, x + w - 1);
+      write(PASET, y, y + h - 1);
+      write(RAMWR);
+      for (uint8_t mask = 1; height != 0; height--, mask <<= 1) {
+	for (uint8_t s = 0; s < scale; s++) {
+	  for (uint8_t j = 0; j < width; j++)
+	    write((bp[j] & mask) ? fg.rgb : bg.rgb, scale);
+	}
+      }
+    spi.end();
+  spi.release();
 }
 
 void
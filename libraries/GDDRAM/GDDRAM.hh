@@ -66,12 +66,48 @@ public:
 
   /**
    * @override{Canvas}
-   * Draw image on canvas at given position.
+   * Set address window (CASET, PASET) and start memory write (RAMWR).
+   * The pixels are streamed with window_write() and window_fill().
    * @param[in] x.
    * @param[in] y.
-   * @param[in] image.
+   * @param[in] width.
+   * @param[in] height.
+   */
+  virtual void window_begin(uint16_t x, uint16_t y,
+			    uint16_t width, uint16_t height);
+
+  /**
+   * @override{Canvas}
+   * Write the given pixels to the address window.
+   * @param[in] buf pixel buffer.
+   * @param[in] count number of pixels.
+   */
+  virtual void window_write(const color16_t* buf, size_t count);
+
+  /**
+   * @override{Canvas}
+   * Write the given number of pixels with the given color to the
+   * address window.
+   * @param[in] color.
+   * @param[in] count number of pixels.
+   */
+  virtual void window_fill(color16_t color, uint16_t count);
+
+  /**
+   * @override{Canvas}
+   * Draw glyph strip with current pen color and given scale. In
+   * opaque text mode the strip is written as a single address window
+   * with text and canvas color pixels.
+   * @param[in] x position.
+   * @param[in] y position.
+   * @param[in] bp column bytes.
+   * @param[in] width number of columns.
+   * @param[in] height number of rows (1..8).
+   * @param[in] scale.
    */
-  virtual void draw_image(uint16_t x, uint16_t y, Image* image);
+  virtual void draw_glyph(uint16_t x, uint16_t y, const uint8_t* bp,
+			  uint8_t width, uint8_t height,
+			  uint8_t scale = 1);
 
   /**
    * @override{Canvas}
@@ -97,20 +97,55 @@ HD44780::display_off()
 void
 HD44780::display_clear()
 {
-  write(CLEAR_DISPLAY);
+  write_long(CLEAR_DISPLAY);
   m_x = 0;
   m_y = 0;
   m_mode |= INCREMENT;
-  DELAY(LONG_EXEC_TIME);
 }
 
 void
 HD44780::cursor_home()
 {
-  write(RETURN_HOME);
+  write_long(RETURN_HOME);
   m_x = 0;
   m_y = 0;
-  DELAY(LONG_EXEC_TIME);
+}
+
+bool
+HD44780::is_busy()
+{
+  if (m_io->has_busy_flag()) return (m_io->is_busy());
+  if (!m_pending) return (false);
+
+  // Poll the remaining execution time
+  if ((m_micros() - m_start) < LONG_EXEC_TIME) return (true);
+  m_pending = false;
+  return (false);
+}
+
+void
+HD44780::write_long(uint8_t cmd)
+{
+  // The next write will poll the busy flag
+  write(cmd);
+  if (m_io->has_busy_flag()) return;
+
+  // Otherwise mark start of execution time, or wait if there is no clock
+  if (m_micros == NULL) {
+    DELAY(LONG_EXEC_TIME);
+    return;
+  }
+  m_start = m_micros();
+  m_pending = true;
+}
+
+void
+HD44780::await()
+{
+  // Wait for the remaining execution time
+  uint32_t elapsed = m_micros() - m_start;
+  if (elapsed < LONG_EXEC_TIME) DELAY(LONG_EXEC_TIME - elapsed);
+  m_pending = false;
 }
 
 void
@@ -218,6 +253,7 @@ HD44780::putchar(char c)
 int
 HD44780::write(const void* buf, size_t size)
 {
+  if (UNLIKELY(m_pending)) await();
   set_data_mode();
   {
     m_io->write8n(buf, size);
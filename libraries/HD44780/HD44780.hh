@@ -24,6 +24,7 @@
 #include "Cosa/SPI.hh"
 #include "Cosa/LCD.hh"
 #include "Cosa/OutputPin.hh"
+#include "Cosa/IOPin.hh"
 
 /**
  * HD44780 (LCD-II) Dot Matix Liquid Crystal Display Controller/Driver
@@ -31,6 +32,13 @@
  * scroll, cursor, and handling of special characters such as carriage-
  * return, form-feed, back-space, horizontal tab and new-line.
  *
+ * @section Limitations
+ * Instructions are not queued. Only the execution time of the long
+ * instructions (clear and home) is deferred to the next display
+ * access; this requires an adapter with busy flag or a micro-second
+ * clock (see set_clock()). Otherwise the full execution time is
+ * waited for.
+ *
  * @section References
  * 1. Product Specification, Hitachi, HD4478U, ADE-207-272(Z), '99.9, Rev. 0.0.
  */
@@ -87,6 +95,29 @@ public:
      * @param[in] flag.
      */
     virtual void set_backlight(uint8_t flag) = 0;
+
+    /**
+     * @override{HD44780::IO}
+     * Return true(1) if the adapter may read the display busy flag
+     * (RW connected) otherwise false(0). Adapters without busy flag
+     * use fixed execution time delays. Default false(0).
+     * @return bool.
+     */
+    virtual bool has_busy_flag()
+    {
+      return (false);
+    }
+
+    /**
+     * @override{HD44780::IO}
+     * Read display busy flag. Return true(1) if an instruction is
+     * in progress otherwise false(0). Default false(0).
+     * @return bool.
+     */
+    virtual bool is_busy()
+    {
+      return (false);
+    }
   };
 
   /** Max size of custom character font bitmap. */
@@ -113,7 +144,10 @@ public:
     m_mode(ENTRY_MODE_SET | INCREMENT),
     m_cntl(CONTROL_SET),
     m_func(FUNCTION_SET | DATA_LENGTH_4BITS | NR_LINES_2 | FONT_5X8DOTS),
-    m_offset((height == 4) && (width == 16) ? offset1 : offset0)
+    m_offset((height == 4) && (width == 16) ? offset1 : offset0),
+    m_micros(NULL),
+    m_pending(false),
+    m_start(0)
   {}
 
   /**
@@ -175,10 +209,34 @@ public:
 
   /**
    * @override{LCD::Device}
-   * Clear display and move cursor to home(0, 0).
+   * Clear display and move cursor to home(0, 0). The execution time
+   * is deferred when the adapter has busy flag or a clock is set;
+   * the next display access waits for the remaining time (or busy
+   * flag) and other work may be performed in between.
    */
   virtual void display_clear();
 
+  /**
+   * Return true(1) if the display is executing an instruction
+   * otherwise false(0). Long instructions (clear and home) are
+   * tracked with the clock when the adapter does not have busy flag.
+   * @return bool.
+   */
+  bool is_busy();
+
+  /**
+   * Set micro-second clock used to defer the execution time of long
+   * instructions when the adapter does not have busy flag, e.g.
+   * RTT::micros after RTT::begin(). The clock must be running while
+   * set. Default none; the full execution time is waited for.
+   * @param[in] micros clock function (NULL to wait).
+   */
+  void set_clock(uint32_t (*micros)())
+  {
+    if (UNLIKELY(m_pending)) await();
+    m_micros = micros;
+  }
+
   /**
    * Clear to end of line.
    */
@@ -188,7 +246,8 @@ public:
   }
 
   /**
-   * Move cursor to home position(0, 0) .
+   * Move cursor to home position(0, 0). The execution time is
+   * deferred as for display_clear().
    */
   void cursor_home();
 
@@ -417,6 +476,13 @@ public:
     /** Execution time delay (us). */
     static const uint16_t SHORT_EXEC_TIME = 32;
 
+    /**
+     * Write byte (8bit) to display as two nibbles without execution
+     * time delay.
+     * @param[in] data (8b) to write.
+     */
+    void write2x4b(uint8_t data);
+
     OutputPin m_d0;		//!< Data pin; d0.
     OutputPin m_d1;		//!< Data pin; d1.
     OutputPin m_d2;		//!< Data pin; d2.
@@ -427,6 +493,81 @@ public:
   };
 #endif
 
+#if !defined(BOARD_ATTINY)
+  /**
+   * HD44780 (LCD-II) Dot Matix Liquid Crystal Display Controller/Driver
+   * IO Port. Arduino pins directly to LCD in 4-bit mode with RW pin
+   * connected. The busy flag is polled before each write instead of
+   * waiting the worst-case execution time. Circuit as Port4b with
+   * LCD RW connected to the rw pin (Default D12).
+   */
+  class Port4bRW : public Port4b {
+  public:
+    /**
+     * Construct HD44780 4-bit parallel port with busy flag read
+     * connected to given read/write select, data, command, enable and
+     * backlight pin.
+     * @param[in] rw read/write select pin (Default D12).
+     * @param[in] d0 data pin (Default D4).
+     * @param[in] d1 data pin (Default D5).
+     * @param[in] d2 data pin (Default D6).
+     * @param[in] d3 data pin (Default D7).
+     * @param[in] rs command/data select pin (Default D8).
+     * @param[in] en enable pin (Default D9).
+     * @param[in] bt backlight pin (Default D10).
+     */
+    Port4bRW(Board::DigitalPin rw = Board::D12,
+	     Board::DigitalPin d0 = Board::D4,
+	     Board::DigitalPin d1 = Board::D5,
+	     Board::DigitalPin d2 = Board::D6,
+	     Board::DigitalPin d3 = Board::D7,
+	     Board::DigitalPin rs = Board::D8,
+	     Board::DigitalPin en = Board::D9,
+	     Board::DigitalPin bt = Board::D10) :
+      Port4b(d0, d1, d2, d3, rs, en, bt),
+      m_rw(rw, 0)
+    {}
+
+    /**
+     * @override{HD44780::IO}
+     * Wait for busy flag and write byte (8bit) to display.
+     * @param[in] data (8b) to write.
+     */
+    virtual void write8b(uint8_t data);
+
+    /**
+     * @override{HD44780::IO}
+     * Return true(1) as the busy flag may be read.
+     * @return bool.
+     */
+    virtual bool has_busy_flag()
+    {
+      return (true);
+    }
+
+    /**
+     * @override{HD44780::IO}
+     * Read display busy flag. Return true(1) if an instruction is
+     * in progress otherwise false(0).
+     * @return bool.
+     */
+    virtual bool is_busy();
+
+  protected:
+    /** Max number of busy flag polls before write (approx. 4 ms). */
+    static const uint16_t BUSY_POLL_MAX = 512;
+
+    OutputPin m_rw;		//!< Read/write select (0/write, 1/read).
+
+    /**
+     * Set data pins to given mode; input for read and output for
+     * write.
+     * @param[in] mode of data pins.
+     */
+    void data_mode(IOPin::Mode mode);
+  };
+#endif
+
   /**
    * HD44780 (LCD-II) Dot Matix Liquid Crystal Display Controller/Driver
    * Shift Register 3-Wire Port (SR3W), 74HC595/74HC164 (SR[pin]),
@@ -911,6 +1052,21 @@ public:
   uint8_t m_cntl;		//!< Control.
   uint8_t m_func;		//!< Function set.
   const uint8_t* m_offset;	//!< Row offset table.
+  uint32_t (*m_micros)();	//!< Clock for deferred execution time.
+  bool m_pending;		//!< Long instruction in progress.
+  uint32_t m_start;		//!< Long instruction start time (us).
+
+  /**
+   * Write long instruction (clear or home) to display. The execution
+   * time is deferred to the next display access.
+   * @param[in] cmd instruction to write.
+   */
+  void write_long(uint8_t cmd);
+
+  /**
+   * Wait for remaining execution time of long instruction.
+   */
+  void await();
 
   /**
    * Write data or command to display.
@@ -919,6 +1075,7 @@ public:
   void write(uint8_t data)
     __attribute__((always_inline))
   {
+    if (UNLIKELY(m_pending)) await();
     m_io->write8b(data);
   }
 
@@ -930,7 +1087,7 @@ public:
   void set(uint8_t& cmd, uint8_t mask)
     __attribute__((always_inline))
   {
-    m_io->write8b(cmd |= mask);
+    write(cmd |= mask);
   }
 
   /**
@@ -941,7 +1098,7 @@ public:
   void clear(uint8_t& cmd, uint8_t mask)
     __attribute__((always_inline))
   {
-    m_io->write8b(cmd &= ~mask);
+    write(cmd &= ~mask);
   }
 
   /**
@@ -43,6 +43,13 @@ HD44780::Port4b::write4b(uint8_t data)
 
 void
 HD44780::Port4b::write8b(uint8_t data)
+{
+  write2x4b(data);
+  DELAY(SHORT_EXEC_TIME);
+}
+
+void
+HD44780::Port4b::write2x4b(uint8_t data)
 {
   synchronized {
     m_d0._set(data & 0x10);
@@ -58,7 +65,6 @@ HD44780::Port4b::write8b(uint8_t data)
     m_en._toggle();
     m_en._toggle();
   }
-  DELAY(SHORT_EXEC_TIME);
 }
 
 void
@@ -72,4 +78,47 @@ HD44780::Port4b::set_backlight(uint8_t flag)
 {
   m_bt.write(flag);
 }
+
+#if !defined(BOARD_ATTINY)
+void
+HD44780::Port4bRW::write8b(uint8_t data)
+{
+  // Poll the busy flag; bounded in case the display is not connected
+  for (uint16_t i = 0; i < BUSY_POLL_MAX && is_busy(); i++) DELAY(8);
+  write2x4b(data);
+}
+
+bool
+HD44780::Port4bRW::is_busy()
+{
+  bool res;
+  bool rs = m_rs.is_set();
+  data_mode(IOPin::INPUT_MODE);
+  synchronized {
+    // Read busy flag and address counter; instruction register
+    m_rs._clear();
+    m_rw._set();
+    m_en._set();
+    DELAY(1);
+    res = m_d3.is_set();
+    m_en._clear();
+    m_en._set();
+    DELAY(1);
+    m_en._clear();
+    m_rw._clear();
+    m_rs._set(rs);
+  }
+  data_mode(IOPin::OUTPUT_MODE);
+  return (res);
+}
+
+void
+HD44780::Port4bRW::data_mode(IOPin::Mode mode)
+{
+  IOPin::mode((Board::DigitalPin) m_d0.pin(), mode);
+  IOPin::mode((Board::DigitalPin) m_d1.pin(), mode);
+  IOPin::mode((Board::DigitalPin) m_d2.pin(), mode);
+  IOPin::mode((Board::DigitalPin) m_d3.pin(), mode);
+}
+#endif
 #endif
@@ -0,0 +1,238 @@
+/**
+ * @file KVStore.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "KVStore.hh"
+#include <util/crc16.h>
+
+static uint16_t
+crc_xmodem(uint16_t crc, const void* buf, size_t len)
+{
+  const uint8_t* bp = (const uint8_t*) buf;
+  while (len--) crc = _crc_xmodem_update(crc, *bp++);
+  return (crc);
+}
+
+int
+KVStore::begin()
+{
+  // Sanity check the sector size
+  if (UNLIKELY(m_size < sizeof(sector_t) + sizeof(record_t) + VALUE_MAX))
+    return (EINVAL);
+
+  // Select the valid sector with the latest sequence number
+  sector_t header[2];
+  bool valid[2];
+  valid[0] = read_sector(0, header[0]);
+  valid[1] = read_sector(1, header[1]);
+  uint8_t sector;
+  if (valid[0] && valid[1])
+    sector = ((int32_t) (header[1].seq - header[0].seq) > 0);
+  else if (valid[0] || valid[1])
+    sector = valid[1];
+
+  // Or format the rom block
+  else {
+    int res = write_sector(0, 0L);
+    if (UNLIKELY(res < 0)) return (res);
+    sector = 0;
+    header[0].seq = 0L;
+  }
+  m_sector = sector;
+  return (scan(sector, header[sector].seq));
+}
+
+int
+KVStore::read(uint8_t key, void* buf, size_t size)
+{
+  if (UNLIKELY(key >= KEY_MAX)) return (EINVAL);
+  uint16_t offset = m_index[key];
+  if (offset == 0) return (ENOENT);
+  record_t rec;
+  uint8_t* rp = address(m_sector, offset);
+  if (UNLIKELY(m_dev->read(&rec, rp, sizeof(rec)) != sizeof(rec)))
+    return (EIO);
+  if (UNLIKELY(rec.len > size)) return (EMSGSIZE);
+  if (UNLIKELY(m_dev->read(buf, rp + sizeof(rec), rec.len) != rec.len))
+    return (EIO);
+  return (rec.len);
+}
+
+int
+KVStore::write(uint8_t key, const void* buf, size_t size)
+{
+  if (UNLIKELY(key >= KEY_MAX || size == 0 || size > VALUE_MAX))
+    return (EINVAL);
+
+  // Skip unchanged value
+  uint8_t value[VALUE_MAX];
+  if (read(key, value, sizeof(value)) == (int) size
+      && memcmp(value, buf, size) == 0)
+    return (size);
+
+  // Append new value to the log
+  int res = append(key, buf, size);
+  if (UNLIKELY(res < 0)) return (res);
+  return (size);
+}
+
+int
+KVStore::remove(uint8_t key)
+{
+  if (UNLIKELY(key >= KEY_MAX)) return (EINVAL);
+  if (m_index[key] == 0) return (ENOENT);
+  return (append(key, NULL, 0));
+}
+
+int
+KVStore::compact()
+{
+  uint8_t sector = m_sector ^ 1;
+  uint32_t seq = m_seq;
+  uint16_t offset = sizeof(sector_t);
+  uint16_t index[KEY_MAX];
+  uint8_t value[VALUE_MAX];
+
+  // Copy the latest values to the other sector
+  for (uint8_t key = 0; key < KEY_MAX; key++) {
+    index[key] = 0;
+    int len = read(key, value, sizeof(value));
+    if (len == ENOENT) continue;
+    if (UNLIKELY(len < 0)) return (len);
+    if (UNLIKELY(offset + sizeof(record_t) + len > m_size)) return (ENOSPC);
+    int res = write_record(sector, offset, seq, key, value, len);
+    if (UNLIKELY(res < 0)) return (res);
+    index[key] = offset;
+    offset += res;
+    seq += 1;
+  }
+
+  // Commit by writing the sector header; the sector is now active
+  int res = write_sector(sector, m_seq);
+  if (UNLIKELY(res < 0)) return (res);
+  memcpy(m_index, index, sizeof(m_index));
+  m_sector = sector;
+  m_tail = offset;
+  m_seq = seq;
+  return (available());
+}
+
+bool
+KVStore::read_sector(uint8_t sector, sector_t& header)
+{
+  if (m_dev->read(&header, address(sector, 0), sizeof(header))
+      != sizeof(header))
+    return (false);
+  if (header.magic != MAGIC) return (false);
+  return (header.crc == checksum(&header));
+}
+
+int
+KVStore::write_sector(uint8_t sector, uint32_t seq)
+{
+  sector_t header;
+  header.magic = MAGIC;
+  header.seq = seq;
+  header.crc = checksum(&header);
+  if (UNLIKELY(m_dev->write(address(sector, 0), &header, sizeof(header))
+	       != sizeof(header)))
+    return (EIO);
+  return (0);
+}
+
+int
+KVStore::scan(uint8_t sector, uint32_t seq)
+{
+  uint16_t offset = sizeof(sector_t);
+  uint8_t value[VALUE_MAX];
+  record_t rec;
+
+  // Replay the log until unexpected sequence number or check-sum error
+  memset(m_index, 0, sizeof(m_index));
+  while (offset + sizeof(rec) <= m_size) {
+    uint8_t* rp = address(sector, offset);
+    if (UNLIKELY(m_dev->read(&rec, rp, sizeof(rec)) != sizeof(rec)))
+      return (EIO);
+    if (rec.seq != (uint16_t) seq) break;
+    if (rec.len > VALUE_MAX) break;
+    if (offset + sizeof(rec) + rec.len > m_size) break;
+    if (UNLIKELY(m_dev->read(value, rp + sizeof(rec), rec.len) != rec.len))
+      return (EIO);
+    if (rec.crc != checksum(seq, &rec, value)) break;
+    if (rec.key < KEY_MAX) m_index[rec.key] = (rec.len == 0) ? 0 : offset;
+    offset += sizeof(rec) + rec.len;
+    seq += 1;
+  }
+  m_tail = offset;
+  m_seq = seq;
+  return (0);
+}
+
+int
+KVStore::write_record(uint8_t sector, uint16_t offset, uint32_t seq,
+		      uint8_t key, const void* buf, uint8_t len)
+{
+  record_t rec;
+  rec.seq = seq;
+  rec.key = key;
+  rec.len = len;
+  rec.crc = checksum(seq, &rec, buf);
+
+  // Write value before header; the header completes the record
+  uint8_t* rp = address(sector, offset);
+  if (len != 0 && m_dev->write(rp + sizeof(rec), buf, len) != len)
+    return (EIO);
+  if (UNLIKELY(m_dev->write(rp, &rec, sizeof(rec)) != sizeof(rec)))
+    return (EIO);
+  return (sizeof(rec) + len);
+}
+
+int
+KVStore::append(uint8_t key, const void* buf, uint8_t len)
+{
+  // Compact the log when the active sector is full
+  if (m_tail + sizeof(record_t) + len > m_size) {
+    int res = compact();
+    if (UNLIKELY(res < 0)) return (res);
+    if (UNLIKELY(sizeof(record_t) + len > (size_t) res)) return (ENOSPC);
+  }
+
+  // Append the record and update the index
+  int res = write_record(m_sector, m_tail, m_seq, key, buf, len);
+  if (UNLIKELY(res < 0)) return (res);
+  m_index[key] = (len == 0) ? 0 : m_tail;
+  m_tail += res;
+  m_seq += 1;
+  return (0);
+}
+
+uint16_t
+KVStore::checksum(const sector_t* header)
+{
+  uint16_t crc = crc_xmodem(0xffff, &header->magic, sizeof(header->magic));
+  return (crc_xmodem(crc, &header->seq, sizeof(header->seq)));
+}
+
+uint16_t
+KVStore::checksum(uint32_t seq, const record_t* rec, const void* buf)
+{
+  uint16_t crc = crc_xmodem(0xffff, &seq, sizeof(seq));
+  crc = crc_xmodem(crc, &rec->key, sizeof(rec->key) + sizeof(rec->len));
+  return (crc_xmodem(crc, buf, rec->len));
+}
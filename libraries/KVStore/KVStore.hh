@@ -0,0 +1,301 @@
+/**
+ * @file KVStore.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_KVSTORE_HH
+#define COSA_KVSTORE_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/EEPROM.hh"
+
+// Default number of keys and max value size
+#ifndef COSA_KVSTORE_KEY_MAX
+# define COSA_KVSTORE_KEY_MAX 16
+#endif
+#ifndef COSA_KVSTORE_VALUE_MAX
+# define COSA_KVSTORE_VALUE_MAX 32
+#endif
+
+/**
+ * Wear-levelled key/value store for EEPROM devices. The given rom
+ * block is divided into two sectors. Values are appended as records
+ * to the log in the active sector; the cells of a value are not
+ * rewritten when the value is updated. When the active sector is
+ * full the latest values are copied (compacted) to the other sector
+ * which then becomes the active sector. Writes are spread over the
+ * whole rom block.
+ *
+ * Each record has a sequence number and a check-sum (CRC-16/XMODEM)
+ * of the 32-bit sequence number, key, length and value. The log ends
+ * at the first record with an unexpected sequence number or check-sum
+ * error; an interrupted write is ignored. The sector header with the
+ * sequence number of the first record is written last in compaction
+ * and selects the active sector. A RAM index with the latest record
+ * of each key is rebuilt by begin() and gives constant time lookup.
+ *
+ * @section Limitations
+ * Keys are in the range 0..KEY_MAX-1 and values are max VALUE_MAX
+ * bytes. A value must not be zero length; zero length records mark
+ * removed keys.
+ */
+class KVStore {
+public:
+  /** Number of keys. */
+  static const uint8_t KEY_MAX = COSA_KVSTORE_KEY_MAX;
+
+  /** Max size of value. */
+  static const uint8_t VALUE_MAX = COSA_KVSTORE_VALUE_MAX;
+
+  /**
+   * Construct key/value store on given EEPROM device with given rom
+   * block address and size. The block is divided into two sectors.
+   * @param[in] dev EEPROM device.
+   * @param[in] base address of rom block.
+   * @param[in] size of rom block in bytes.
+   */
+  KVStore(EEPROM::Device* dev, void* base, size_t size) :
+    m_dev(dev),
+    m_base((uint8_t*) base),
+    m_size(size / 2),
+    m_sector(0),
+    m_tail(0),
+    m_seq(0L)
+  {
+    memset(m_index, 0, sizeof(m_index));
+  }
+
+  /**
+   * Locate the active sector and rebuild the index from the log. A
+   * rom block without valid sectors is formatted. Returns zero(0) if
+   * successful otherwise a negative error code; EINVAL(-22) if the
+   * sector size is too small and EIO(-5) on device error.
+   * @return zero or negative error code.
+   */
+  int begin();
+
+  /**
+   * Read value for given key into given buffer with given max size.
+   * Returns the size of the value or a negative error code;
+   * EINVAL(-22) illegal key, ENOENT(-2) no value, EMSGSIZE(-90) value
+   * does not fit the buffer and EIO(-5) on device error.
+   * @param[in] key.
+   * @param[in] buf buffer for value.
+   * @param[in] size of buffer.
+   * @return size of value or negative error code.
+   */
+  int read(uint8_t key, void* buf, size_t size);
+
+  /**
+   * Template function to read value of given type for given key.
+   * Returns the size of the value or a negative error code.
+   * @param[in] key.
+   * @param[out] value.
+   * @return size of value or negative error code.
+   */
+  template<class T> int read(uint8_t key, T* value)
+  {
+    return (read(key, value, sizeof(T)));
+  }
+
+  /**
+   * Write given value with given size for given key. The value is
+   * appended to the log if changed. The log is compacted when the
+   * active sector is full. Returns the size of the value or a
+   * negative error code; EINVAL(-22) illegal key or size, ENOSPC(-28)
+   * no space after compaction and EIO(-5) on device error.
+   * @param[in] key.
+   * @param[in] buf value.
+   * @param[in] size of value.
+   * @return size of value or negative error code.
+   */
+  int write(uint8_t key, const void* buf, size_t size);
+
+  /**
+   * Template function to write value of given type for given key.
+   * Returns the size of the value or a negative error code.
+   * @param[in] key.
+   * @param[in] value.
+   * @return size of value or negative error code.
+   */
+  template<class T> int write(uint8_t key, const T* value)
+  {
+    return (write(key, value, sizeof(T)));
+  }
+
+  /**
+   * Remove value for given key. Returns zero(0) if successful
+   * otherwise a negative error code; EINVAL(-22) illegal key,
+   * ENOENT(-2) no value, ENOSPC(-28) no space after compaction and
+   * EIO(-5) on device error.
+   * @param[in] key.
+   * @return zero or negative error code.
+   */
+  int remove(uint8_t key);
+
+  /**
+   * Copy the latest values to the other sector and make it the
+   * active sector. Returns number of bytes available in the active
+   * sector or a negative error code; ENOSPC(-28) values do not fit
+   * and EIO(-5) on device error.
+   * @return bytes available or negative error code.
+   */
+  int compact();
+
+  /**
+   * Return number of bytes available in the active sector.
+   * @return bytes.
+   */
+  size_t available() const
+  {
+    return (m_size - m_tail);
+  }
+
+  /**
+   * Return sequence number of the next record.
+   * @return sequence number.
+   */
+  uint32_t sequence() const
+  {
+    return (m_seq);
+  }
+
+protected:
+  /** Sector header. */
+  struct sector_t {
+    uint16_t magic;		//!< Sector magic.
+    uint32_t seq;		//!< Sequence number of first record.
+    uint16_t crc;		//!< Header check-sum.
+  };
+
+  /** Record header; followed by value. */
+  struct record_t {
+    uint16_t seq;		//!< Sequence number (low 16-bit).
+    uint8_t key;		//!< Key.
+    uint8_t len;		//!< Value length (zero for removed).
+    uint16_t crc;		//!< Record check-sum.
+  };
+
+  /** Sector magic. */
+  static const uint16_t MAGIC = 0x4b56;
+
+  /** EEPROM device. */
+  EEPROM::Device* m_dev;
+
+  /** Rom block address. */
+  uint8_t* m_base;
+
+  /** Sector size. */
+  const uint16_t m_size;
+
+  /** Active sector. */
+  uint8_t m_sector;
+
+  /** Offset of next record in active sector. */
+  uint16_t m_tail;
+
+  /** Sequence number of next record. */
+  uint32_t m_seq;
+
+  /** Offset of latest record for each key (zero for no value). */
+  uint16_t m_index[KEY_MAX];
+
+  /**
+   * Return rom address of given offset in given sector.
+   * @param[in] sector index.
+   * @param[in] offset in sector.
+   * @return rom address.
+   */
+  uint8_t* address(uint8_t sector, uint16_t offset) const
+  {
+    return (m_base + (sector * m_size) + offset);
+  }
+
+  /**
+   * Read header of given sector and return true(1) if valid otherwise
+   * false(0).
+   * @param[in] sector index.
+   * @param[out] header sector header.
+   * @return bool.
+   */
+  bool read_sector(uint8_t sector, sector_t& header);
+
+  /**
+   * Write header of given sector with given sequence number. Returns
+   * zero(0) if successful otherwise a negative error code.
+   * @param[in] sector index.
+   * @param[in] seq sequence number of first record.
+   * @return zero or negative error code.
+   */
+  int write_sector(uint8_t sector, uint32_t seq);
+
+  /**
+   * Scan the log in given sector from the given sequence number and
+   * rebuild the index, tail and sequence number. Returns zero(0) if
+   * successful otherwise a negative error code.
+   * @param[in] sector index.
+   * @param[in] seq sequence number of first record.
+   * @return zero or negative error code.
+   */
+  int scan(uint8_t sector, uint32_t seq);
+
+  /**
+   * Write record with given sequence number, key and value at given
+   * offset in given sector. Returns size of record if successful
+   * otherwise a negative error code.
+   * @param[in] sector index.
+   * @param[in] offset in sector.
+   * @param[in] seq sequence number.
+   * @param[in] key.
+   * @param[in] buf value.
+   * @param[in] len size of value.
+   * @return size of record or negative error code.
+   */
+  int write_record(uint8_t sector, uint16_t offset, uint32_t seq,
+		   uint8_t key, const void* buf, uint8_t len);
+
+  /**
+   * Append record with given key and value to the active sector.
+   * The log is compacted if needed. Returns zero(0) if successful
+   * otherwise a negative error code.
+   * @param[in] key.
+   * @param[in] buf value.
+   * @param[in] len size of value.
+   * @return zero or negative error code.
+   */
+  int append(uint8_t key, const void* buf, uint8_t len);
+
+  /**
+   * Calculate sector header check-sum.
+   * @param[in] header sector header.
+   * @return check-sum.
+   */
+  static uint16_t checksum(const sector_t* header);
+
+  /**
+   * Calculate record check-sum for given sequence number, record
+   * header and value.
+   * @param[in] seq sequence number.
+   * @param[in] rec record header.
+   * @param[in] buf value.
+   * @return check-sum.
+   */
+  static uint16_t checksum(uint32_t seq, const record_t* rec, const void* buf);
+};
+
+#endif
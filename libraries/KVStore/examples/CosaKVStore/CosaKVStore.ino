@@ -0,0 +1,69 @@
+/**
+ * @file CosaKVStore.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demonstration of the wear-levelled key/value store on the internal
+ * EEPROM. A boot counter and a run-time counter are restored on
+ * start-up and updated periodically. The log sequence number and
+ * available bytes in the active sector are printed.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <KVStore.h>
+
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+#include "Cosa/Watchdog.hh"
+
+// Keys
+#define BOOTS 0
+#define TICKS 1
+
+// Key/value store in internal EEPROM
+uint8_t block[256] EEMEM;
+KVStore store(&EEPROM::Device::eeprom, block, sizeof(block));
+
+uint16_t boots = 0;
+uint32_t ticks = 0;
+
+void setup()
+{
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaKVStore: started"));
+  Watchdog::begin();
+
+  // Restore and update the counters
+  ASSERT(store.begin() == 0);
+  store.read(BOOTS, &boots);
+  store.read(TICKS, &ticks);
+  boots += 1;
+  ASSERT(store.write(BOOTS, &boots) == sizeof(boots));
+}
+
+void loop()
+{
+  // Update the run-time counter; appended to the log
+  ticks += 1;
+  ASSERT(store.write(TICKS, &ticks) == sizeof(ticks));
+  trace << PSTR("boots=") << boots
+	<< PSTR(",ticks=") << ticks
+	<< PSTR(",seq=") << store.sequence()
+	<< PSTR(",available=") << store.available()
+	<< endl;
+  sleep(5);
+}
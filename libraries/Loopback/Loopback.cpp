@@ -0,0 +1,152 @@
+/**
+ * @file Loopback.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Loopback.hh"
+#include "Cosa/RTT.hh"
+
+void
+Loopback::Channel::transmit(Loopback* src, uint8_t dest, uint8_t port,
+			    const iovec_t* vec, size_t len)
+{
+  uint32_t time = RTT::millis() + m_latency;
+  m_stats.sent += 1;
+  m_stats.bytes += len;
+
+  // Deliver to all nodes on the same network and channel
+  for (Loopback* node = m_node; node != NULL; node = node->m_next) {
+    if (node == src) continue;
+    if (node->m_addr.network != src->m_addr.network) continue;
+    if (node->m_channel != src->m_channel) continue;
+    if (dest != BROADCAST && dest != node->m_addr.device) continue;
+    if (!is_connected(src->m_addr.device, node->m_addr.device)) continue;
+
+    // Check loss rate and room in node inbox
+    if (m_loss != 0 && (uint8_t) random() < m_loss) {
+      m_stats.lost += 1;
+      continue;
+    }
+    uint8_t next = (node->m_put + 1) % INBOX_MAX;
+    if (next == node->m_get) {
+      m_stats.dropped += 1;
+      continue;
+    }
+
+    // Copy message to node inbox
+    message_t* msg = &node->m_inbox[node->m_put];
+    msg->time = time;
+    msg->src = src->m_addr.device;
+    msg->dest = dest;
+    msg->port = port;
+    msg->len = len;
+    uint8_t* dp = msg->payload;
+    for (const iovec_t* vp = vec; vp->buf != NULL; vp++) {
+      memcpy(dp, vp->buf, vp->size);
+      dp += vp->size;
+    }
+    node->m_put = next;
+    m_stats.delivered += 1;
+  }
+}
+
+bool
+Loopback::begin(const void* config)
+{
+  UNUSED(config);
+  if (is_attached()) return (true);
+  m_next = m_chan->m_node;
+  m_chan->m_node = this;
+  m_put = 0;
+  m_get = 0;
+  return (true);
+}
+
+bool
+Loopback::end()
+{
+  Loopback* prev = NULL;
+  for (Loopback* node = m_chan->m_node; node != NULL; node = node->m_next) {
+    if (node != this) {
+      prev = node;
+      continue;
+    }
+    if (prev == NULL)
+      m_chan->m_node = m_next;
+    else
+      prev->m_next = m_next;
+    m_next = NULL;
+    m_put = 0;
+    m_get = 0;
+    return (true);
+  }
+  return (false);
+}
+
+bool
+Loopback::available()
+{
+  if (m_put == m_get) return (false);
+  return ((int32_t) (RTT::millis() - m_inbox[m_get].time) >= 0);
+}
+
+int
+Loopback::send(uint8_t dest, uint8_t port, const iovec_t* vec)
+{
+  // Sanity check the payload size and node state
+  if (UNLIKELY(vec == NULL)) return (EINVAL);
+  size_t len = iovec_size(vec);
+  if (UNLIKELY(len > m_chan->m_payload)) return (EMSGSIZE);
+  if (UNLIKELY(!is_attached())) return (ENOTCONN);
+
+  // Deliver to connected nodes
+  m_chan->transmit(this, dest, port, vec, len);
+  return (len);
+}
+
+int
+Loopback::recv(uint8_t& src, uint8_t& port, void* buf, size_t len, uint32_t ms)
+{
+  // Wait for a message; inbox is in delivery time order
+  uint32_t start = RTT::millis();
+  while (!available()) {
+    if ((ms != 0) && (RTT::since(start) > ms)) return (ETIME);
+    yield();
+  }
+
+  // Copy the message and remove from inbox
+  message_t* msg = &m_inbox[m_get];
+  int res = msg->len;
+  if (UNLIKELY((size_t) res > len))
+    res = EMSGSIZE;
+  else
+    memcpy(buf, msg->payload, res);
+  src = msg->src;
+  port = msg->port;
+  m_dest = msg->dest;
+  m_get = (m_get + 1) % INBOX_MAX;
+  return (res);
+}
+
+bool
+Loopback::is_attached() const
+{
+  for (Loopback* node = m_chan->m_node; node != NULL; node = node->m_next)
+    if (node == this) return (true);
+  return (false);
+}
@@ -0,0 +1,355 @@
+/**
+ * @file Loopback.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_LOOPBACK_HH
+#define COSA_LOOPBACK_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/Wireless.hh"
+
+// Default frame and inbox size
+#ifndef COSA_LOOPBACK_FRAME_MAX
+# define COSA_LOOPBACK_FRAME_MAX 64
+#endif
+#ifndef COSA_LOOPBACK_INBOX_MAX
+# define COSA_LOOPBACK_INBOX_MAX 4
+#endif
+
+/**
+ * Simulated Wireless device driver. Any number of virtual nodes may
+ * be connected to an in-process Channel. Messages are delivered to
+ * the nodes on the same network and channel after the configured
+ * latency, and lost with the configured loss rate. The payload limit
+ * and the reported input power level and link quality indicator are
+ * also configurable. Allows protocol layers, retransmit policies and
+ * throughput to be tested and benchmarked without radio hardware.
+ * The driver does not use any device registers.
+ *
+ * @section Limitations
+ * Messages are delivered on recv() and available(); there is no
+ * background delivery. A node inbox that is full drops messages.
+ */
+class Loopback : public Wireless::Driver {
+public:
+  /** Max size of frame payload. */
+  static const size_t FRAME_MAX = COSA_LOOPBACK_FRAME_MAX;
+
+  /** Number of messages in node inbox. */
+  static const uint8_t INBOX_MAX = COSA_LOOPBACK_INBOX_MAX;
+
+  /**
+   * Simulated channel; connects virtual nodes and holds the channel
+   * characteristics and statistics. Sub-class and override
+   * is_connected() to model a topology.
+   */
+  class Channel {
+  public:
+    /** Channel statistics. */
+    struct stats_t {
+      uint32_t sent;		//!< Number of messages sent.
+      uint32_t delivered;	//!< Number of messages delivered.
+      uint32_t lost;		//!< Number of messages lost (loss rate).
+      uint32_t dropped;		//!< Number of messages dropped (inbox full).
+      uint32_t bytes;		//!< Number of payload bytes sent.
+    };
+
+    /**
+     * Construct simulated channel with given latency, loss rate and
+     * payload limit.
+     * @param[in] latency delivery delay in milli-seconds (Default 0).
+     * @param[in] loss loss rate per 256 messages (Default 0).
+     * @param[in] payload max payload size (Default FRAME_MAX).
+     */
+    Channel(uint16_t latency = 0, uint8_t loss = 0,
+	    uint8_t payload = FRAME_MAX) :
+      m_latency(latency),
+      m_loss(loss),
+      m_payload(payload > FRAME_MAX ? FRAME_MAX : payload),
+      m_rssi(-40),
+      m_lqi(0),
+      m_node(NULL)
+    {
+      memset(&m_stats, 0, sizeof(m_stats));
+    }
+
+    /**
+     * Set delivery delay in milli-seconds.
+     * @param[in] ms latency.
+     */
+    void latency(uint16_t ms)
+    {
+      m_latency = ms;
+    }
+
+    /**
+     * Get delivery delay in milli-seconds.
+     * @return latency.
+     */
+    uint16_t latency() const
+    {
+      return (m_latency);
+    }
+
+    /**
+     * Set loss rate; number of lost messages per 256.
+     * @param[in] rate loss rate.
+     */
+    void loss(uint8_t rate)
+    {
+      m_loss = rate;
+    }
+
+    /**
+     * Get loss rate; number of lost messages per 256.
+     * @return loss rate.
+     */
+    uint8_t loss() const
+    {
+      return (m_loss);
+    }
+
+    /**
+     * Set max payload size. Limited to FRAME_MAX.
+     * @param[in] size max payload size.
+     */
+    void payload(uint8_t size)
+    {
+      m_payload = (size > FRAME_MAX ? FRAME_MAX : size);
+    }
+
+    /**
+     * Get max payload size.
+     * @return max payload size.
+     */
+    uint8_t payload() const
+    {
+      return (m_payload);
+    }
+
+    /**
+     * Set input power level (dBm) and link quality indicator reported
+     * by the nodes.
+     * @param[in] rssi input power level.
+     * @param[in] lqi link quality indicator.
+     */
+    void link(int8_t rssi, uint8_t lqi)
+    {
+      m_rssi = rssi;
+      m_lqi = lqi;
+    }
+
+    /**
+     * Return statistics.
+     * @return statistics.
+     */
+    const stats_t& stats() const
+    {
+      return (m_stats);
+    }
+
+    /**
+     * Reset statistics.
+     */
+    void reset()
+    {
+      memset(&m_stats, 0, sizeof(m_stats));
+    }
+
+    /**
+     * @override{Loopback::Channel}
+     * Return true(1) if a message from the given source device may
+     * reach the given destination device otherwise false(0). Default
+     * all nodes are connected.
+     * @param[in] src source device address.
+     * @param[in] dest destination device address.
+     * @return bool.
+     */
+    virtual bool is_connected(uint8_t src, uint8_t dest)
+    {
+      UNUSED(src);
+      UNUSED(dest);
+      return (true);
+    }
+
+  protected:
+    friend class Loopback;
+    uint16_t m_latency;		//!< Delivery delay (ms).
+    uint8_t m_loss;		//!< Loss rate per 256 messages.
+    uint8_t m_payload;		//!< Max payload size.
+    int8_t m_rssi;		//!< Input power level (dBm).
+    uint8_t m_lqi;		//!< Link quality indicator.
+    Loopback* m_node;		//!< List of connected nodes.
+    stats_t m_stats;		//!< Statistics.
+
+    /**
+     * Deliver message in given buffer and length from given source
+     * node to all connected nodes on the same network and channel
+     * with the given destination address (or broadcast).
+     * @param[in] src source node.
+     * @param[in] dest destination device address.
+     * @param[in] port device port (or message type).
+     * @param[in] vec null terminated io vector.
+     * @param[in] len total length of io vector.
+     */
+    void transmit(Loopback* src, uint8_t dest, uint8_t port,
+		  const iovec_t* vec, size_t len);
+  };
+
+  /**
+   * Construct simulated Wireless device driver on given channel with
+   * given network and device address.
+   * @param[in] channel simulated channel.
+   * @param[in] net network address.
+   * @param[in] dev device address.
+   */
+  Loopback(Channel* channel, int16_t net, uint8_t dev) :
+    Wireless::Driver(net, dev),
+    m_chan(channel),
+    m_next(NULL),
+    m_put(0),
+    m_get(0)
+  {}
+
+  /**
+   * @override{Wireless::Driver}
+   * Connect the node to the channel. Return true(1) if successful
+   * otherwise false(0).
+   * @param[in] config configuration vector (not used).
+   * @return bool.
+   */
+  virtual bool begin(const void* config = NULL);
+
+  /**
+   * @override{Wireless::Driver}
+   * Disconnect the node from the channel and flush the inbox.
+   * Return true(1) if successful otherwise false(0).
+   * @return bool.
+   */
+  virtual bool end();
+
+  /**
+   * @override{Wireless::Driver}
+   * Return true(1) if a message is available (latency passed)
+   * otherwise false(0).
+   * @return bool.
+   */
+  virtual bool available();
+
+  /**
+   * @override{Wireless::Driver}
+   * Send message in given null terminated io vector. Returns number
+   * of bytes sent if successful otherwise a negative error code;
+   * EINVAL(-22) if illegal vector, EMSGSIZE(-90) if greater than
+   * channel payload limit, ENOTCONN(-107) if not connected.
+   * @param[in] dest destination network address.
+   * @param[in] port device port (or message type).
+   * @param[in] vec null termianted io vector.
+   * @return number of bytes send or negative error code.
+   */
+  virtual int send(uint8_t dest, uint8_t port, const iovec_t* vec);
+
+  /**
+   * @override{Wireless::Driver}
+   * Send message in given buffer, with given number of bytes. Returns
+   * number of bytes sent if successful otherwise a negative error code.
+   * @param[in] dest destination network address.
+   * @param[in] port device port (or message type).
+   * @param[in] buf buffer to transmit.
+   * @param[in] len number of bytes in buffer.
+   * @return number of bytes send or negative error code.
+   */
+  virtual int send(uint8_t dest, uint8_t port, const void* buf, size_t len)
+  {
+    return (Wireless::Driver::send(dest, port, buf, len));
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Receive message and store into given buffer with given maximum
+   * length. The source network address is returned in the parameter
+   * src. Returns the number of received bytes or a negative error
+   * code; ETIME(-62) on timeout and EMSGSIZE(-90) if the message does
+   * not fit the buffer (the message is discarded).
+   * @param[out] src source network address.
+   * @param[out] port device port (or message type).
+   * @param[in] buf buffer to store incoming message.
+   * @param[in] len maximum number of bytes to receive.
+   * @param[in] ms maximum time out period.
+   * @return number of bytes received or negative error code.
+   */
+  virtual int recv(uint8_t& src, uint8_t& port,
+		   void* buf, size_t len,
+		   uint32_t ms = 0L);
+
+  /**
+   * @override{Wireless::Driver}
+   * Return channel input power level (dBm).
+   * @return power level in dBm.
+   */
+  virtual int input_power_level()
+  {
+    return (m_chan->m_rssi);
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Return channel link quality indicator.
+   * @return quality indicator.
+   */
+  virtual int link_quality_indicator()
+  {
+    return (m_chan->m_lqi);
+  }
+
+protected:
+  /** Inbox message. */
+  struct message_t {
+    uint32_t time;		//!< Delivery time (ms).
+    uint8_t src;		//!< Source device address.
+    uint8_t dest;		//!< Destination device address.
+    uint8_t port;		//!< Device port.
+    uint8_t len;		//!< Payload length.
+    uint8_t payload[FRAME_MAX];	//!< Payload.
+  };
+
+  /** Simulated channel. */
+  Channel* m_chan;
+
+  /** Next node on channel. */
+  Loopback* m_next;
+
+  /** Inbox ring-buffer. */
+  message_t m_inbox[INBOX_MAX];
+
+  /** Inbox put index. */
+  uint8_t m_put;
+
+  /** Inbox get index. */
+  uint8_t m_get;
+
+  /**
+   * Return true(1) if this node is connected to the channel otherwise
+   * false(0).
+   * @return bool.
+   */
+  bool is_attached() const;
+};
+
+#endif
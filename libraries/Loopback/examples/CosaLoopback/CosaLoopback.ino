@@ -0,0 +1,83 @@
+/**
+ * @file CosaLoopback.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa simulated Wireless driver demo; a sender and a receiver node
+ * on a simulated channel with latency and loss. Measures message
+ * throughput and delivery rate.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <Loopback.h>
+
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/RTT.hh"
+
+// Configuration; network and device addresses
+#define NETWORK 0xC05A
+#define SENDER 0x01
+#define RECEIVER 0x02
+#define PORT 0x10
+
+// Simulated channel; 2 ms latency, 10% loss, 32 byte payload
+Loopback::Channel channel(2, 25, 32);
+Loopback sender(&channel, NETWORK, SENDER);
+Loopback receiver(&channel, NETWORK, RECEIVER);
+
+void setup()
+{
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaLoopback: started"));
+  Watchdog::begin();
+  RTT::begin();
+  sender.begin();
+  receiver.begin();
+}
+
+void loop()
+{
+  static const uint16_t COUNT = 1000;
+  static const uint32_t TIMEOUT = 10;
+  uint8_t msg[32];
+  uint8_t src;
+  uint8_t port;
+  uint16_t received = 0;
+
+  // Send messages and receive them on the other node
+  channel.reset();
+  uint32_t start = RTT::micros();
+  for (uint16_t nr = 0; nr < COUNT; nr++) {
+    sender.send(RECEIVER, PORT, msg, sizeof(msg));
+    if (receiver.recv(src, port, msg, sizeof(msg), TIMEOUT) == sizeof(msg))
+      received += 1;
+  }
+  uint32_t us = RTT::micros() - start;
+
+  // Print results and statistics
+  const Loopback::Channel::stats_t& stats = channel.stats();
+  trace << PSTR("received=") << received
+	<< PSTR(",us/msg=") << us / COUNT
+	<< PSTR(",sent=") << stats.sent
+	<< PSTR(",delivered=") << stats.delivered
+	<< PSTR(",lost=") << stats.lost
+	<< PSTR(",dropped=") << stats.dropped
+	<< endl;
+  sleep(2);
+}
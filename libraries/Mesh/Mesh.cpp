@@ -0,0 +1,273 @@
+/**
+ * @file Mesh.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Mesh.hh"
+#include "Cosa/RTT.hh"
+
+/** Link receive time-out when frames are waiting to be forwarded (ms). */
+static const uint32_t RETRY_DELAY = 16;
+
+Mesh::Mesh(Wireless::Driver* dev) :
+  Wireless::Driver(dev->network_address(), dev->device_address()),
+  m_dev(dev),
+  m_next(0),
+  m_seq(0),
+  m_hops(0)
+{
+  memset(m_route, 0, sizeof(m_route));
+  memset(m_seen, 0, sizeof(m_seen));
+  memset(&m_stats, 0, sizeof(m_stats));
+}
+
+bool
+Mesh::begin(const void* config)
+{
+  // Use the address and channel of the link device
+  address(m_dev->network_address(), m_dev->device_address());
+  channel(m_dev->channel());
+
+  // Clear routing table, cache and queue
+  memset(m_route, 0, sizeof(m_route));
+  memset(m_seen, 0, sizeof(m_seen));
+  memset(&m_stats, 0, sizeof(m_stats));
+  frame_t frame;
+  while (m_queue.dequeue(&frame));
+  m_next = 0;
+  return (m_dev->begin(config));
+}
+
+int
+Mesh::send(uint8_t dest, uint8_t port, const iovec_t* vec)
+{
+  // Sanity check the payload size
+  if (UNLIKELY(vec == NULL)) return (EINVAL);
+  size_t len = iovec_size(vec);
+  if (UNLIKELY(len > PAYLOAD_MAX)) return (EMSGSIZE);
+
+  // Build the frame; header and payload
+  frame_t frame;
+  frame.header.dest = dest;
+  frame.header.src = m_addr.device;
+  frame.header.seq = ++m_seq;
+  frame.header.hops = 0;
+  frame.header.port = port;
+  frame.len = len;
+  frame.retry = 0;
+  uint8_t* dp = frame.payload;
+  for (const iovec_t* vp = vec; vp->buf != NULL; vp++) {
+    memcpy(dp, vp->buf, vp->size);
+    dp += vp->size;
+  }
+
+  // Suppress echo of our own frame when flooded back
+  is_duplicate(frame.header.src, frame.header.seq);
+
+  // Transmit directly; only forwarded frames are queued
+  int res = transmit(&frame);
+  if (UNLIKELY(res < 0)) return (res);
+  m_stats.sent += 1;
+  return (len);
+}
+
+int
+Mesh::recv(uint8_t& src, uint8_t& port, void* buf, size_t len, uint32_t ms)
+{
+  uint32_t start = RTT::millis();
+  frame_t frame;
+  uint8_t link;
+  uint8_t lport;
+
+  while (1) {
+    // Forward any waiting frames and calculate link receive time-out
+    forward();
+    uint32_t timeout = 0L;
+    if (ms != 0) {
+      uint32_t elapsed = RTT::since(start);
+      if (elapsed >= ms) return (ETIME);
+      timeout = ms - elapsed;
+    }
+    if (m_queue.available() && (timeout == 0 || timeout > RETRY_DELAY))
+      timeout = RETRY_DELAY;
+
+    // Receive next link message
+    int res = m_dev->recv(link, lport, &frame.header, FRAME_MAX, timeout);
+    if (res == ETIME) continue;
+    if (UNLIKELY(res < 0)) return (res);
+
+    // Pass through single-hop messages on other ports
+    if (lport != MESH_PORT) {
+      if (UNLIKELY((size_t) res > len)) return (EMSGSIZE);
+      memcpy(buf, &frame.header, res);
+      src = link;
+      port = lport;
+      m_dest = m_dev->is_broadcast() ? BROADCAST : m_addr.device;
+      m_hops = 1;
+      return (res);
+    }
+
+    // Sanity check the frame and ignore echo of our own frames
+    if (UNLIKELY((size_t) res < sizeof(header_t))) {
+      m_stats.dropped += 1;
+      continue;
+    }
+    header_t header = frame.header;
+    if (header.src == m_addr.device) {
+      m_stats.duplicates += 1;
+      continue;
+    }
+
+    // Learn route to the link neighbour and the originating source
+    learn(link, link, 1);
+    learn(header.src, link, header.hops + 1);
+    if (is_duplicate(header.src, header.seq)) {
+      m_stats.duplicates += 1;
+      continue;
+    }
+
+    // Store frames for other devices (and broadcast) for forwarding
+    size_t size = res - sizeof(header_t);
+    if (header.dest != m_addr.device) {
+      if (header.hops + 1 < HOPS_MAX) {
+	frame.header.hops += 1;
+	frame.len = size;
+	frame.retry = 0;
+	if (!m_queue.enqueue(&frame)) m_stats.dropped += 1;
+      }
+      else m_stats.dropped += 1;
+      if (header.dest != BROADCAST) continue;
+    }
+
+    // Deliver the payload
+    if (UNLIKELY(size > len)) return (EMSGSIZE);
+    memcpy(buf, frame.payload, size);
+    src = header.src;
+    port = header.port;
+    m_dest = header.dest;
+    m_hops = header.hops + 1;
+    m_stats.received += 1;
+    forward();
+    return (size);
+  }
+}
+
+int
+Mesh::forward()
+{
+  uint8_t count = m_queue.available();
+  int res = 0;
+  frame_t frame;
+
+  // Transmit queued frames; requeue failed until max attempts
+  while (count--) {
+    if (!m_queue.dequeue(&frame)) break;
+    if (transmit(&frame) >= 0) {
+      m_stats.forwarded += 1;
+      res += 1;
+    }
+    else if (++frame.retry < RETRY_MAX) {
+      m_queue.enqueue(&frame);
+    }
+    else m_stats.dropped += 1;
+  }
+  return (res);
+}
+
+uint8_t
+Mesh::hops(uint8_t dest)
+{
+  route_t* route = lookup(dest);
+  return (route == NULL ? 0 : route->hops);
+}
+
+Mesh::route_t*
+Mesh::lookup(uint8_t dest)
+{
+  if (UNLIKELY(dest == BROADCAST)) return (NULL);
+  for (uint8_t i = 0; i < ROUTE_MAX; i++) {
+    route_t* route = &m_route[i];
+    if (route->dest != dest) continue;
+    if (RTT::since(route->time) < ROUTE_TIMEOUT) return (route);
+    route->dest = BROADCAST;
+    return (NULL);
+  }
+  return (NULL);
+}
+
+void
+Mesh::learn(uint8_t dest, uint8_t next, uint8_t hops)
+{
+  if (UNLIKELY(dest == BROADCAST || dest == m_addr.device)) return;
+
+  // Update existing route if shorter, same next hop or expired
+  route_t* route = lookup(dest);
+  if (route != NULL) {
+    if (hops > route->hops && next != route->next) return;
+  }
+
+  // Otherwise use free or oldest entry
+  else {
+    uint32_t oldest = 0L;
+    route = m_route;
+    for (uint8_t i = 0; i < ROUTE_MAX; i++) {
+      if (m_route[i].dest == BROADCAST) {
+	route = &m_route[i];
+	break;
+      }
+      uint32_t age = RTT::since(m_route[i].time);
+      if (age > oldest) {
+	oldest = age;
+	route = &m_route[i];
+      }
+    }
+  }
+  route->dest = dest;
+  route->next = next;
+  route->hops = hops;
+  route->time = RTT::millis();
+}
+
+bool
+Mesh::is_duplicate(uint8_t src, uint8_t seq)
+{
+  for (uint8_t i = 0; i < CACHE_MAX; i++)
+    if (m_seen[i].src == src && m_seen[i].seq == seq) return (true);
+  m_seen[m_next].src = src;
+  m_seen[m_next].seq = seq;
+  m_next += 1;
+  if (m_next == CACHE_MAX) m_next = 0;
+  return (false);
+}
+
+int
+Mesh::transmit(frame_t* frame)
+{
+  // Unicast to next hop if a route is known otherwise flood
+  route_t* route = lookup(frame->header.dest);
+  uint8_t next = (route == NULL) ? BROADCAST : route->next;
+  size_t size = sizeof(header_t) + frame->len;
+  int res = m_dev->send(next, MESH_PORT, &frame->header, size);
+
+  // Drop the route on failure and fall back to flooding
+  if (res < 0 && route != NULL) {
+    route->dest = BROADCAST;
+    res = m_dev->send(BROADCAST, MESH_PORT, &frame->header, size);
+  }
+  return (res);
+}
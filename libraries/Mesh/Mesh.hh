@@ -0,0 +1,371 @@
+/**
+ * @file Mesh.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_MESH_HH
+#define COSA_MESH_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/Queue.hh"
+#include "Cosa/Wireless.hh"
+
+// Default table and queue sizes
+#ifndef COSA_MESH_ROUTE_MAX
+# define COSA_MESH_ROUTE_MAX 8
+#endif
+#ifndef COSA_MESH_CACHE_MAX
+# define COSA_MESH_CACHE_MAX 8
+#endif
+#ifndef COSA_MESH_QUEUE_MAX
+# define COSA_MESH_QUEUE_MAX 4
+#endif
+
+/**
+ * Multi-hop routing and store-and-forward layer for Wireless device
+ * drivers. The Mesh is itself a Wireless::Driver and may be used
+ * where ever a single-hop driver is used. Messages are sent on the
+ * given link device with the link port MESH_PORT and a small header
+ * with originating source, final destination, sequence number, hop
+ * count and application port.
+ *
+ * Routes are learned from received frames; the link source of a frame
+ * is the next hop towards the originating source. Messages to
+ * destinations without a known route, and broadcasts, are flooded.
+ * Each node suppresses duplicates with a cache of recently seen
+ * (source, sequence) pairs and forwards frames for other nodes
+ * through a store-and-forward queue. Frames on other link ports are
+ * passed through as single-hop messages.
+ *
+ * @section Limitations
+ * The frame size is limited to the smallest payload of the supported
+ * drivers (FRAME_MAX). Routes are only learned from traffic; a node
+ * that never sends is only reached by flooding.
+ */
+class Mesh : public Wireless::Driver {
+public:
+  /** Link port used for mesh frames. */
+  static const uint8_t MESH_PORT = 0xfe;
+
+  /** Max number of hops a frame may travel. */
+  static const uint8_t HOPS_MAX = 7;
+
+  /** Max number of transmit attempts for a queued frame. */
+  static const uint8_t RETRY_MAX = 3;
+
+  /** Route time to live (ms). */
+  static const uint32_t ROUTE_TIMEOUT = 300000UL;
+
+  /** Number of entries in routing table. */
+  static const uint8_t ROUTE_MAX = COSA_MESH_ROUTE_MAX;
+
+  /** Number of entries in duplicate suppression cache. */
+  static const uint8_t CACHE_MAX = COSA_MESH_CACHE_MAX;
+
+  /** Number of entries in store-and-forward queue (power of 2). */
+  static const uint8_t QUEUE_MAX = COSA_MESH_QUEUE_MAX;
+
+  /** Mesh frame header. */
+  struct header_t {
+    uint8_t dest;		//!< Final destination device address.
+    uint8_t src;		//!< Originating source device address.
+    uint8_t seq;		//!< Originating source sequence number.
+    uint8_t hops;		//!< Number of hops traveled.
+    uint8_t port;		//!< Application port.
+  };
+
+  /** Max size of link frame; smallest payload of drivers. */
+  static const size_t FRAME_MAX = 30;
+
+  /** Max size of payload. */
+  static const size_t PAYLOAD_MAX = FRAME_MAX - sizeof(header_t);
+
+  /** Routing table entry. */
+  struct route_t {
+    uint8_t dest;		//!< Destination device address.
+    uint8_t next;		//!< Next hop device address.
+    uint8_t hops;		//!< Number of hops to destination.
+    uint32_t time;		//!< Latest update (ms).
+  };
+
+  /** Statistics. */
+  struct stats_t {
+    uint16_t sent;		//!< Number of originated frames.
+    uint16_t received;		//!< Number of delivered frames.
+    uint16_t forwarded;		//!< Number of forwarded frames.
+    uint16_t duplicates;	//!< Number of suppressed duplicates.
+    uint16_t dropped;		//!< Number of dropped frames.
+  };
+
+  /**
+   * Construct mesh layer on given wireless device driver. The network
+   * and device address are taken from the driver.
+   * @param[in] dev wireless device driver.
+   */
+  Mesh(Wireless::Driver* dev);
+
+  /**
+   * @override{Wireless::Driver}
+   * Start the link device driver and clear routing table, cache and
+   * queue. Return true(1) if successful otherwise false(0).
+   * @param[in] config configuration vector (default NULL).
+   * @return bool.
+   */
+  virtual bool begin(const void* config = NULL);
+
+  /**
+   * @override{Wireless::Driver}
+   * Shut down the link device driver. Return true(1) if successful
+   * otherwise false(0).
+   * @return bool.
+   */
+  virtual bool end()
+  {
+    return (m_dev->end());
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Set link device in power up mode.
+   */
+  virtual void powerup()
+  {
+    m_dev->powerup();
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Set link device in power down mode.
+   */
+  virtual void powerdown()
+  {
+    m_dev->powerdown();
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Return true(1) if a link message is available otherwise false(0).
+   * The message may be a frame that is forwarded.
+   * @return bool.
+   */
+  virtual bool available()
+  {
+    return (m_dev->available());
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Return true(1) if there is room to send on the link device
+   * otherwise false(0).
+   * @return bool.
+   */
+  virtual bool room()
+  {
+    return (m_dev->room());
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Send message in given null terminated io vector to the given
+   * destination; directly or through the next hop in the routing
+   * table, otherwise flooded. Returns number of bytes sent if
+   * successful otherwise a negative error code; EINVAL(-22) if
+   * illegal vector and EMSGSIZE(-90) if greater than PAYLOAD_MAX.
+   * @param[in] dest destination device address.
+   * @param[in] port device port (or message type).
+   * @param[in] vec null termianted io vector.
+   * @return number of bytes send or negative error code.
+   */
+  virtual int send(uint8_t dest, uint8_t port, const iovec_t* vec);
+
+  /**
+   * @override{Wireless::Driver}
+   * Send message in given buffer, with given number of bytes. Returns
+   * number of bytes sent if successful otherwise a negative error code.
+   * @param[in] dest destination device address.
+   * @param[in] port device port (or message type).
+   * @param[in] buf buffer to transmit.
+   * @param[in] len number of bytes in buffer.
+   * @return number of bytes send or negative error code.
+   */
+  virtual int send(uint8_t dest, uint8_t port, const void* buf, size_t len)
+  {
+    return (Wireless::Driver::send(dest, port, buf, len));
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Receive message addressed to this device (or broadcast) and store
+   * into given buffer with given maximum length. Frames for other
+   * devices are forwarded while waiting. The originating source
+   * address is returned in the parameter src. Returns the number of
+   * received bytes or a negative error code; ETIME(-62) on timeout
+   * and EMSGSIZE(-90) if the payload does not fit the buffer.
+   * @param[out] src source device address.
+   * @param[out] port device port (or message type).
+   * @param[in] buf buffer to store incoming message.
+   * @param[in] len maximum number of bytes to receive.
+   * @param[in] ms maximum time out period.
+   * @return number of bytes received or negative error code.
+   */
+  virtual int recv(uint8_t& src, uint8_t& port,
+		   void* buf, size_t len,
+		   uint32_t ms = 0L);
+
+  /**
+   * @override{Wireless::Driver}
+   * Set link device output power level in dBm.
+   * @param[in] dBm.
+   */
+  virtual void output_power_level(int8_t dBm)
+  {
+    m_dev->output_power_level(dBm);
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Return link device estimated input power level (dBm).
+   * @return power level in dBm.
+   */
+  virtual int input_power_level()
+  {
+    return (m_dev->input_power_level());
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Return link device link quality indicator.
+   * @return quality indicator.
+   */
+  virtual int link_quality_indicator()
+  {
+    return (m_dev->link_quality_indicator());
+  }
+
+  /**
+   * Transmit frames in the store-and-forward queue. Frames that fail
+   * are retried on the next call, up to RETRY_MAX attempts. Returns
+   * number of frames transmitted.
+   * @return number of frames.
+   */
+  int forward();
+
+  /**
+   * Return number of hops to given destination or zero(0) if no
+   * route is known.
+   * @param[in] dest destination device address.
+   * @return number of hops.
+   */
+  uint8_t hops(uint8_t dest);
+
+  /**
+   * Return hop count of the latest received message.
+   * @return number of hops.
+   */
+  uint8_t hops() const
+  {
+    return (m_hops);
+  }
+
+  /**
+   * Return statistics.
+   * @return statistics.
+   */
+  const stats_t& stats() const
+  {
+    return (m_stats);
+  }
+
+protected:
+  /** Link frame; header, payload, retry counter and link destination. */
+  struct frame_t {
+    header_t header;		//!< Mesh header.
+    uint8_t payload[PAYLOAD_MAX]; //!< Payload.
+    uint8_t len;		//!< Payload length.
+    uint8_t retry;		//!< Number of transmit attempts.
+  };
+
+  /** Duplicate suppression cache entry. */
+  struct seen_t {
+    uint8_t src;		//!< Originating source.
+    uint8_t seq;		//!< Sequence number.
+  };
+
+  /** Link device driver. */
+  Wireless::Driver* m_dev;
+
+  /** Routing table. */
+  route_t m_route[ROUTE_MAX];
+
+  /** Duplicate suppression cache; ring-buffer. */
+  seen_t m_seen[CACHE_MAX];
+
+  /** Next position in duplicate suppression cache. */
+  uint8_t m_next;
+
+  /** Store-and-forward queue. */
+  Queue<frame_t, QUEUE_MAX> m_queue;
+
+  /** Originating sequence number. */
+  uint8_t m_seq;
+
+  /** Hop count of latest received message. */
+  uint8_t m_hops;
+
+  /** Statistics. */
+  stats_t m_stats;
+
+  /**
+   * Lookup route to given destination. Returns pointer to route or
+   * NULL if not found or expired.
+   * @param[in] dest destination device address.
+   * @return route or NULL.
+   */
+  route_t* lookup(uint8_t dest);
+
+  /**
+   * Update routing table with given destination, next hop and hop
+   * count. A shorter or fresher route replaces an existing. The
+   * oldest entry is reused when the table is full.
+   * @param[in] dest destination device address.
+   * @param[in] next next hop device address.
+   * @param[in] hops number of hops.
+   */
+  void learn(uint8_t dest, uint8_t next, uint8_t hops);
+
+  /**
+   * Check duplicate suppression cache for given source and sequence
+   * number. Return true(1) if already seen otherwise the pair is
+   * added and false(0) is returned.
+   * @param[in] src originating source device address.
+   * @param[in] seq sequence number.
+   * @return bool.
+   */
+  bool is_duplicate(uint8_t src, uint8_t seq);
+
+  /**
+   * Transmit given frame on the link device; unicast to next hop if a
+   * route is known otherwise broadcast. Returns number of bytes sent
+   * or negative error code.
+   * @param[in] frame to transmit.
+   * @return number of bytes sent or negative error code.
+   */
+  int transmit(frame_t* frame);
+};
+
+#endif
@@ -0,0 +1,104 @@
+/**
+ * @file CosaMesh.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa Mesh demo; multi-hop messages over a Wireless driver. The
+ * node with address SENDER periodically sends a message to the node
+ * with address DEST. All other nodes act as repeaters and print
+ * messages addressed to them.
+ *
+ * @section Circuit
+ * See Wireless drivers for circuit connections.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <Mesh.h>
+
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/RTT.hh"
+
+// Configuration; network and device addresses
+#define NETWORK 0xC05A
+#define DEVICE 0x01
+#define SENDER 0x01
+#define DEST 0x04
+#define PORT 0x10
+
+// Select Wireless device driver
+// #include <CC1101.h>
+// CC1101 rf(NETWORK, DEVICE);
+
+#include <NRF24L01P.h>
+NRF24L01P rf(NETWORK, DEVICE);
+
+// #include <RFM69.h>
+// RFM69 rf(NETWORK, DEVICE);
+
+Mesh mesh(&rf);
+
+void setup()
+{
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaMesh: started"));
+  Watchdog::begin();
+  RTT::begin();
+  mesh.begin();
+}
+
+void loop()
+{
+  static uint16_t nr = 0;
+  const uint32_t TIMEOUT = 2000;
+  uint8_t msg[Mesh::PAYLOAD_MAX];
+  uint8_t src;
+  uint8_t port;
+
+  // Sender; send a sequence number to the destination
+  if (DEVICE == SENDER) {
+    int res = mesh.send(DEST, PORT, &nr, sizeof(nr));
+    trace << PSTR("send:nr=") << nr
+	  << PSTR(",hops=") << mesh.hops(DEST)
+	  << PSTR(",res=") << res
+	  << endl;
+    nr += 1;
+  }
+
+  // Receive (and forward) messages
+  int count = mesh.recv(src, port, msg, sizeof(msg), TIMEOUT);
+  if (count >= 0) {
+    trace << PSTR("recv:src=") << hex << src
+	  << PSTR(",port=") << hex << port
+	  << PSTR(",hops=") << mesh.hops()
+	  << PSTR(",len=") << count
+	  << endl;
+  }
+  else if (count != ETIME) {
+    trace << PSTR("error(") << count << PSTR(")") << endl;
+  }
+
+  // Print statistics
+  const Mesh::stats_t& stats = mesh.stats();
+  trace << PSTR("stats:sent=") << stats.sent
+	<< PSTR(",received=") << stats.received
+	<< PSTR(",forwarded=") << stats.forwarded
+	<< PSTR(",duplicates=") << stats.duplicates
+	<< PSTR(",dropped=") << stats.dropped
+	<< endl;
+}
@@ -24,6 +24,7 @@
  */
 
 #include "OWI.hh"
+#include "Cosa/Power.hh"
 
 bool
 OWI::reset()
@@ -146,6 +147,265 @@ OWI::alarm_dispatch()
   return (true);
 }
 
+#if defined(TIMER2_COMPA_vect)
+
+/** Timer0 ticks (prescale 64) for given number of micro-seconds. */
+#define TICKS(us) ((uint8_t) (((us) * I_CPU) / 64))
+
+/** Bus timing; reset pulse, presence sample, recovery and bit slot. */
+static const uint8_t RESET_TICKS = TICKS(480);
+static const uint8_t PRESENCE_TICKS = TICKS(70);
+static const uint8_t RECOVERY_TICKS = TICKS(410);
+static const uint8_t SLOT_TICKS = TICKS(70);
+
+OWI* OWI::s_bus = NULL;
+
+int
+OWI::transfer(const void* wbuf, uint8_t wsize,
+	      void* rbuf, uint8_t rsize,
+	      Event::Handler* handler,
+	      bool reset,
+	      bool power)
+{
+  // Check that the timer is not in use
+  synchronized {
+    if (UNLIKELY(s_bus != NULL)) return (EBUSY);
+    s_bus = this;
+  }
+
+  // Set up the transaction
+  m_handler = handler;
+  m_wbuf = (const uint8_t*) wbuf;
+  m_wsize = (wbuf == NULL ? 0 : wsize);
+  m_rbuf = (uint8_t*) rbuf;
+  m_rsize = (rbuf == NULL ? 0 : rsize);
+  m_count = 0;
+  m_bit = 0;
+  m_byte = 0;
+  m_crc = 0;
+  m_search = false;
+  m_power = power;
+  m_result = 0;
+
+  // Start with reset pulse or the first bit slot
+  if (reset) {
+    mode(OUTPUT_MODE);
+    clear();
+    m_state = RESET_STATE;
+    timer_begin(RESET_TICKS);
+  }
+  else {
+    m_state = SLOT_STATE;
+    timer_begin(1);
+  }
+  return (0);
+}
+
+int
+OWI::search(uint8_t cmd, uint8_t* rom, int8_t last, Event::Handler* handler)
+{
+  // Start with reset and rom command; set up search before the
+  // timer interrupt handler may run
+  synchronized {
+    m_cmd = cmd;
+    int res = transfer(&m_cmd, 1, NULL, 0, handler);
+    if (UNLIKELY(res < 0)) return (res);
+    m_rbuf = rom;
+    m_pos = 0;
+    m_last = last;
+    m_next = Driver::LAST;
+    m_step = 0;
+    m_search = true;
+  }
+  return (0);
+}
+
+void
+OWI::timer_begin(uint8_t ticks)
+{
+  Power::timer0_enable();
+  TCCR0B = 0;
+  TCCR0A = _BV(WGM01);
+  TCNT0 = 0;
+  OCR0A = ticks - 1;
+  TIFR0 = _BV(OCF0A);
+  TIMSK0 |= _BV(OCIE0A);
+  TCCR0B = (_BV(CS01) | _BV(CS00));
+}
+
+void
+OWI::timer_end()
+{
+  TIMSK0 &= ~_BV(OCIE0A);
+  TCCR0B = 0;
+}
+
+void
+OWI::complete(int res)
+{
+  timer_end();
+  if (m_power) {
+    mode(OUTPUT_MODE);
+    set();
+  }
+  else power_off();
+  m_result = res;
+  m_state = IDLE_STATE;
+  s_bus = NULL;
+  if (m_handler != NULL)
+    Event::push(Event::COMMAND_COMPLETED_TYPE, m_handler, (uint16_t) res);
+}
+
+void
+OWI::write_bit(uint8_t bit)
+{
+  mode(OUTPUT_MODE);
+  clear();
+  if (bit) {
+    DELAY(6);
+    set();
+  }
+  else {
+    // Time the low period here; the next timer interrupt may be
+    // delayed by other interrupt handlers past the slot maximum
+    DELAY(60);
+    set();
+  }
+}
+
+uint8_t
+OWI::read_bit()
+{
+  mode(OUTPUT_MODE);
+  set();
+  clear();
+  DELAY(6);
+  mode(INPUT_MODE);
+  DELAY(9);
+  uint8_t bit = is_set();
+  uint8_t mix = (m_crc ^ bit);
+  m_crc >>= 1;
+  if (mix & 1) m_crc ^= 0x8C;
+  return (bit);
+}
+
+void
+OWI::on_timer()
+{
+  switch (m_state) {
+  case RESET_STATE:
+    // Release the bus and wait for presence pulse
+    set();
+    mode(INPUT_MODE);
+    m_state = PRESENCE_STATE;
+    OCR0A = PRESENCE_TICKS - 1;
+    return;
+  case PRESENCE_STATE:
+    // Sample presence pulse and wait for reset recovery
+    m_result = is_clear();
+    m_state = RECOVERY_STATE;
+    OCR0A = RECOVERY_TICKS - 1;
+    return;
+  case RECOVERY_STATE:
+    if (UNLIKELY(m_result == 0)) {
+      complete(m_search ? Driver::ERROR : ENXIO);
+      return;
+    }
+    m_state = SLOT_STATE;
+    OCR0A = SLOT_TICKS - 1;
+    break;
+  case SLOT_STATE:
+    OCR0A = SLOT_TICKS - 1;
+    break;
+  default:
+    return;
+  }
+
+  // Write bytes; LSB first
+  if (m_wsize != 0) {
+    write_bit((*m_wbuf >> m_bit) & 1);
+    if (++m_bit == CHARBITS) {
+      m_bit = 0;
+      m_wbuf += 1;
+      m_wsize -= 1;
+    }
+    return;
+  }
+
+  // Read bytes; LSB first
+  if (m_rsize != 0) {
+    m_byte = (m_byte >> 1) | (read_bit() ? 0x80 : 0);
+    if (++m_bit == CHARBITS) {
+      m_bit = 0;
+      *m_rbuf++ = m_byte;
+      m_rsize -= 1;
+      m_count += 1;
+    }
+    return;
+  }
+
+  // Rom search; read bit and complement, and write direction
+  if (m_search && m_pos < ROMBITS) {
+    switch (m_step) {
+    case 0:
+      m_byte = read_bit();
+      m_step = 1;
+      return;
+    case 1:
+      m_byte |= (read_bit() << 1);
+      switch (m_byte) {
+      case 0b00: // Discrepency between device roms
+	if (m_pos == m_last) {
+	  m_byte = 1;
+	  m_last = Driver::FIRST;
+	}
+	else if ((int8_t) m_pos > m_last) {
+	  m_byte = 0;
+	  m_next = m_pos;
+	}
+	else if (m_rbuf[m_pos >> 3] & _BV(m_pos & 7)) {
+	  m_byte = 1;
+	}
+	else {
+	  m_byte = 0;
+	  m_next = m_pos;
+	}
+	break;
+      case 0b01: // Only one's at this position
+	m_byte = 1;
+	break;
+      case 0b10: // Only zero's at this position
+	m_byte = 0;
+	break;
+      case 0b11: // No device detected
+	complete(Driver::ERROR);
+	return;
+      }
+      m_step = 2;
+      return;
+    default:
+      write_bit(m_byte);
+      if (m_byte)
+	m_rbuf[m_pos >> 3] |= _BV(m_pos & 7);
+      else
+	m_rbuf[m_pos >> 3] &= ~_BV(m_pos & 7);
+      m_pos += 1;
+      m_step = 0;
+      return;
+    }
+  }
+
+  // Transaction completed
+  complete(m_search ? m_next : m_count);
+}
+
+ISR(TIMER0_COMPA_vect)
+{
+  if (UNLIKELY(OWI::s_bus == NULL)) return;
+  OWI::s_bus->on_timer();
+}
+#endif
+
 IOStream& operator<<(IOStream& outs, OWI& owi)
 {
   OWI::Driver dev(&owi);
@@ -24,14 +24,25 @@
 #include "Cosa/Types.h"
 #include "Cosa/IOPin.hh"
 #include "Cosa/IOStream.hh"
+#include "Cosa/Event.hh"
 
 /**
  * 1-wire device driver support class. Allows device rom search
  * and connection to multiple devices on one-wire bus.
  *
+ * Reset, write, read and rom search may also be performed
+ * asynchronously; transfer() and search(). The bit slots are driven
+ * by a timer interrupt state machine and completion is signaled with
+ * an event. Interrupts are only turned off for the start of each bit
+ * slot (max 15 us, or 60 us for the low period of a write zero slot)
+ * instead of the whole transaction.
+ *
  * @section Limitations
  * The driver will turn off interrupt handling during data read
- * from the device.
+ * from the device. The asynchronous mode uses Timer0 and is only
+ * available when RTT uses Timer2 (i.e. not on ATtiny and ATmega32U4).
+ * PWM on Timer0 pins is disturbed. Only one bus may be active at a
+ * time.
  */
 class OWI : private IOPin {
 public:
@@ -222,7 +233,10 @@ public:
     IOPin(pin),
     m_devices(0),
     m_device(NULL),
-    m_crc(0)
+    m_crc(0),
+    m_state(IDLE_STATE),
+    m_result(0),
+    m_handler(NULL)
   {}
 
   /**
@@ -292,6 +306,78 @@ public:
    */
   bool alarm_dispatch();
 
+#if defined(TIMER2_COMPA_vect)
+  /**
+   * Start asynchronous transaction on the bus; optional reset, write
+   * given number of bytes from buffer and read given number of bytes
+   * to buffer. An Event::COMMAND_COMPLETED_TYPE with the result is
+   * pushed to the given handler (if not NULL) on completion; the
+   * number of bytes read or ENXIO(-6) if no device presence. The
+   * checksum of the bytes read is given by crc(). Pass true(1) for
+   * power parameter to allow parasite devices to be powered after the
+   * write. Returns zero(0) if started otherwise EBUSY(-16) if a
+   * transaction is in progress.
+   * @param[in] wbuf buffer to write (or NULL).
+   * @param[in] wsize number of bytes to write.
+   * @param[in] rbuf buffer to read to (or NULL).
+   * @param[in] rsize number of bytes to read.
+   * @param[in] handler completion event handler (or NULL).
+   * @param[in] reset bus before transaction (Default true).
+   * @param[in] power on for parasite device (Default false).
+   * @return zero or negative error code.
+   */
+  int transfer(const void* wbuf, uint8_t wsize,
+	       void* rbuf, uint8_t rsize,
+	       Event::Handler* handler,
+	       bool reset = true,
+	       bool power = false);
+
+  /**
+   * Start asynchronous rom search with the given command (SEARCH_ROM
+   * or ALARM_SEARCH), rom buffer and last position of discrepancy
+   * (see Driver::search_rom()). An Event::COMMAND_COMPLETED_TYPE is
+   * pushed to the given handler (if not NULL) on completion with the
+   * position of difference (int8_t), or Driver::ERROR. Returns zero(0)
+   * if started otherwise EBUSY(-16) if a transaction is in progress.
+   * @param[in] cmd rom command.
+   * @param[in] rom buffer (ROM_MAX).
+   * @param[in] last position of discrepancy.
+   * @param[in] handler completion event handler (or NULL).
+   * @return zero or negative error code.
+   */
+  int search(uint8_t cmd, uint8_t* rom, int8_t last,
+	     Event::Handler* handler);
+
+  /**
+   * Return true(1) if an asynchronous transaction is in progress
+   * otherwise false(0).
+   * @return bool.
+   */
+  bool is_busy() const
+  {
+    return (m_state != IDLE_STATE);
+  }
+
+  /**
+   * Return result of latest asynchronous transaction.
+   * @return result.
+   */
+  int result() const
+  {
+    return (m_result);
+  }
+#endif
+
+  /**
+   * Return checksum of latest bytes read; zero(0) if the last byte
+   * read was a correct CRC.
+   * @return crc.
+   */
+  uint8_t crc() const
+  {
+    return (m_crc);
+  }
+
 private:
   /** Number of devices. */
   uint8_t m_devices;
@@ -301,6 +387,99 @@ private:
 
   /** Intermediate CRC sum. */
   uint8_t m_crc;
+
+  /** Asynchronous transaction states. */
+  enum {
+    IDLE_STATE,			//!< No transaction.
+    RESET_STATE,		//!< Reset pulse.
+    PRESENCE_STATE,		//!< Sample presence pulse.
+    RECOVERY_STATE,		//!< Reset recovery.
+    SLOT_STATE			//!< Bit slots; write, read and search.
+  } __attribute__((packed));
+
+  /** Asynchronous transaction state. */
+  volatile uint8_t m_state;
+
+  /** Asynchronous transaction result. */
+  int m_result;
+
+  /** Completion event handler. */
+  Event::Handler* m_handler;
+
+#if defined(TIMER2_COMPA_vect)
+  /** Write buffer and number of bytes. */
+  const uint8_t* m_wbuf;
+  uint8_t m_wsize;
+
+  /** Read buffer (or search rom) and number of bytes. */
+  uint8_t* m_rbuf;
+  uint8_t m_rsize;
+
+  /** Number of bytes read. */
+  uint8_t m_count;
+
+  /** Current bit position and byte value. */
+  uint8_t m_bit;
+  uint8_t m_byte;
+
+  /** Rom command for search. */
+  uint8_t m_cmd;
+
+  /** Search; position, last and next discrepancy, step in position. */
+  uint8_t m_pos;
+  int8_t m_last;
+  int8_t m_next;
+  uint8_t m_step;
+
+  /** Search in progress. */
+  bool m_search;
+
+  /** Power parasite devices on completion. */
+  bool m_power;
+
+  /** Asynchronous transaction bus. */
+  static OWI* s_bus;
+
+  /**
+   * Start timer with given number of ticks to the next state.
+   * @param[in] ticks timer ticks.
+   */
+  static void timer_begin(uint8_t ticks);
+
+  /**
+   * Stop timer.
+   */
+  static void timer_end();
+
+  /**
+   * Interrupt handler; perform next step of transaction.
+   */
+  void on_timer();
+
+  /**
+   * Complete the transaction with the given result; stop timer, set
+   * bus power and push completion event.
+   * @param[in] res result.
+   */
+  void complete(int res);
+
+  /**
+   * Write given bit to bus; start of bit slot. A zero bit holds the
+   * bus low for 60 us and is released before returning so that the
+   * low period does not depend on interrupt latency.
+   * @param[in] bit to write.
+   */
+  void write_bit(uint8_t bit);
+
+  /**
+   * Read bit from bus; start of bit slot.
+   * @return bit.
+   */
+  uint8_t read_bit();
+
+  /** Interrupt Service Routine */
+  friend void TIMER0_COMPA_vect(void);
+#endif
 };
 
 /**
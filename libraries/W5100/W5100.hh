@@ -508,6 +508,18 @@ public:
     /** Length of message in socket transmitter buffer. */
     uint16_t m_tx_len;
 
+    /** Cached socket transmitter write pointer (TX_WR). */
+    uint16_t m_tx_wr;
+
+    /** Cached socket receiver read pointer (RX_RD). */
+    uint16_t m_rx_rd;
+
+    /** Cached number of bytes available in receiver buffer. */
+    uint16_t m_rx_size;
+
+    /** Number of bytes read but not yet released to the device. */
+    uint16_t m_rx_len;
+
     /** Pointer to socket receiver buffer. */
     uint16_t m_rx_buf;
 
@@ -540,10 +552,56 @@ public:
     /**
      * Wait for given maximum message size in internal transmit buffer.
      * Setup transmitter offset and initiate length for new message
-     * construction.
+     * construction. The transmitter write pointer is read from the
+     * device.
      */
     void dev_setup();
 
+    /**
+     * Wait for given maximum message size in internal transmit buffer.
+     * Setup transmitter offset and initiate length for new message
+     * construction from the given (cached) transmitter write pointer.
+     * @param[in] ptr transmitter write pointer.
+     */
+    void dev_setup(uint16_t ptr);
+
+    /**
+     * Refresh receiver cache; release any read data to the device and
+     * read the received size and read pointer registers in a single
+     * burst. Returns number of bytes available.
+     * @return bytes.
+     */
+    int dev_refresh();
+
+    /**
+     * Release read data in the socket receiver buffer to the device;
+     * write the cached read pointer and issue receive command.
+     */
+    void dev_commit();
+
+    /** Max number of 16-bit socket registers in a burst. */
+    static const uint8_t SREG_BURST_MAX = 5;
+
+    /**
+     * Read given number of adjacent 16-bit socket registers, starting
+     * with the given register, in a single burst and convert to host
+     * byte order. At most SREG_BURST_MAX registers.
+     * @param[in] reg first socket register.
+     * @param[in] buf buffer for register values.
+     * @param[in] count number of registers.
+     */
+    void sreg_read(const uint16_t* reg, uint16_t* buf, uint8_t count);
+
+    /**
+     * Write given number of adjacent 16-bit socket registers, starting
+     * with the given register, in a single burst. The values are
+     * given in host byte order. At most SREG_BURST_MAX registers.
+     * @param[in] reg first socket register.
+     * @param[in] buf register values.
+     * @param[in] count number of registers.
+     */
+    void sreg_write(const uint16_t* reg, const uint16_t* buf, uint8_t count);
+
     /**
      * @override{Socket}
      * Write data from buffer with given size to device. Boolean flag